@@ -13,6 +13,8 @@
 #include <algorithm>
 #include <vector>
 #include <iostream>
+#include <sstream>
+#include <chrono>
 
 // ---------------- PROGMEM EMULATION ----------------
 #define PROGMEM
@@ -80,10 +82,40 @@ public:
     void println(T v){ std::cout << v << std::endl; }
     
     void println(){ std::cout << std::endl; }
+
+    // Fixed decimals, like Print::print(double, digits)
+    void print(double v, int digits){ printf("%.*f", digits, v); fflush(stdout); }
+    void println(double v, int digits){ print(v, digits); std::cout << std::endl; }
+
+    size_t write(const uint8_t *buf, size_t len){ std::cout.write((const char*)buf, len); return len; }
+    int available(){ return 0; }
+    int read(){ return -1; }
 };
 
 static SerialMock SerialUSB;
-static SerialMock Serial1;
+
+// Serial1 is the A9G link, answered by the emulator in a9g_emulator.cpp
+class A9GSerial {
+public:
+    void begin(unsigned long baud);
+    int available();
+    int read();
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buf, size_t len);
+
+    template<typename T>
+    void print(T v){ std::ostringstream s; s << v; writeText(s.str().c_str()); }
+
+    template<typename T>
+    void println(T v){ print(v); writeText("\r\n"); }
+
+    void println(){ writeText("\r\n"); }
+
+private:
+    void writeText(const char *s);
+};
+
+extern A9GSerial Serial1;
 
 // ---------------- Arduino Helpers ----------------
 #define F(x) x
@@ -101,7 +133,14 @@ inline int16_t constrain(int16_t x, int16_t a, int16_t b) {
 }
 
 inline void delay(int ms){}
-inline unsigned long millis(){ static unsigned long t=0; return t+=16; }
+
+// Real elapsed time so gesture timing behaves like on the device
+inline unsigned long micros(){
+    static const auto t0 = std::chrono::steady_clock::now();
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count();
+}
+inline unsigned long millis(){ return micros() / 1000; }
 
 #define HIGH 1
 #define LOW 0
@@ -3,9 +3,51 @@
 
 #define FILE_WRITE 1
 #define FILE_READ 0
+#define O_READ 0x01
+#define O_WRITE 0x02
+#define O_CREAT 0x10
+#define O_TRUNC 0x40
 
+#ifdef SD_HOST_FILES
+// Host tools (tools/track_bench.cpp): files in the current directory.
+// Opened for writing only with O_WRITE.
 class File {
 public:
+    FILE *f = nullptr;
+    operator bool() const { return f != nullptr; }
+    int read(){ return fgetc(f); }
+    int read(void *buf, size_t len){ return (int)fread(buf, 1, len, f); }
+    size_t write(const uint8_t *buf, size_t len){ return fwrite(buf, 1, len, f); }
+    void flush() { fflush(f); }
+    bool isDirectory(){ return false; }
+    const char* name(){ return "host"; }
+    uint32_t size(){ long p = ftell(f); fseek(f, 0, SEEK_END); long n = ftell(f); fseek(f, p, SEEK_SET); return (uint32_t)n; }
+    bool available(){ int c = fgetc(f); if (c == EOF) return false; ungetc(c, f); return true; }
+    bool seek(uint32_t pos){ return fseek(f, pos, SEEK_SET) == 0; }
+    void close() { if (f) fclose(f); f = nullptr; }
+};
+
+class SDClass {
+public:
+    bool begin(uint8_t){ return true; }
+    File open(const char *path, int mode=0){
+        File file;
+        if (!(mode & O_WRITE)) file.f = fopen(path, "rb");
+        else if (mode & O_TRUNC) file.f = fopen(path, "w+b");
+        else if (!(file.f = fopen(path, "r+b")) && (mode & O_CREAT)) file.f = fopen(path, "w+b");
+        return file;
+    }
+    bool exists(const char *path){ FILE *f = fopen(path, "rb"); if (f) fclose(f); return f != nullptr; }
+    bool remove(const char *path){ return ::remove(path) == 0; }
+};
+#else
+class File {
+public:
+    operator bool() const { return false; } // No card in the simulator
+    int read(){ return -1; }
+    int read(void*, size_t){ return -1; }
+    size_t write(const uint8_t*, size_t){ return 0; }
+    void flush() {}
     bool isDirectory(){ return false; }
     const char* name(){ return "stub.txt"; }
     uint32_t size(){ return 0; }
@@ -13,7 +55,7 @@ public:
     String readStringUntil(char){ return ""; }
     void print(...) {}
     void println(...) {}
-    void seek(int) {}
+    bool seek(uint32_t){ return false; }
     void close() {}
 };
 
@@ -23,5 +65,6 @@ public:
     File open(const char*, int mode=0){ return File(); }
     bool exists(const char*){ return false; }
 };
+#endif
 
 static SDClass SD;
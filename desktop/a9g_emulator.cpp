@@ -0,0 +1,391 @@
+/**
+ * @file a9g_emulator.cpp
+ * @brief A9G Module Emulator Behind the Simulator's Serial1
+ *
+ * Answers the AT commands the firmware sends in the real module's line
+ * format (echo, response lines, final result code), sends URCs such as
+ * READY and +HTTPACTION, and after AT+GPSRD emits "+GPSRD:" prefixed NMEA
+ * every period. Output is released at the UART byte rate, so the AT
+ * engine sees partial lines and replies that take real time, like on
+ * hardware.
+ *
+ * Time to first fix depends on what the receiver starts from, as on the
+ * real module: EMU_COLD_MS without ephemeris, EMU_WARM_MS when it still
+ * holds ephemeris from a fix less than EMU_EPHEMERIS_MS ago, and
+ * EMU_AGPS_MS after AT+AGPS=1 has downloaded it over GPRS. The first
+ * start after boot is cold, or assisted when the firmware asks for AGPS;
+ * GPS CLEAR on the debug page gives a warm one. A9G_EMU_GPRS=0 in the
+ * environment models no network: AT+CGATT? answers 0, and AGPS and the
+ * cell tower position (AT+LOCATION=1) fail.
+ */
+
+#include <deque>
+#include <string>
+#include <Arduino.h>
+
+A9GSerial Serial1;
+
+// ===================================
+// Emulator Model
+// ===================================
+
+#define EMU_BYTE_US 87          // One byte at 115200 8N1
+#define EMU_READY_MS 2000       // "READY" after Serial1.begin()
+#define EMU_REPLY_MS 15         // Command turnaround
+#define EMU_COLD_MS 20000       // GPS on to first fix, no ephemeris (scaled down)
+#define EMU_WARM_MS 3000        // GPS on to first fix with valid ephemeris
+#define EMU_AGPS_DL_MS 1500     // AT+AGPS=1 to its "OK": assistance download
+#define EMU_AGPS_MS 4000        // Assistance data in to first fix
+#define EMU_EPHEMERIS_MS 14400000UL // Ephemeris from a fix stays usable this long
+#define EMU_HTTP_MS 900         // AT+HTTPACTION to its +HTTPACTION URC
+#define EMU_LBS_MS 1200         // AT+LOCATION=1 to its reply (location server lookup)
+
+#define EMU_LAT 28.613900       // New Delhi, as the old canned stub data
+#define EMU_LON 77.209000
+#define EMU_ALT 210.5
+#define EMU_CELL_LAT 28.616400  // Serving cell's position, ~350 m off
+#define EMU_CELL_LON 77.211500
+
+typedef struct
+{
+    uint32_t startUs;
+    std::string text;
+    size_t pos; // Bytes already read
+} EmuChunk;
+
+static std::deque<EmuChunk> emuOut;
+static uint32_t emuOutEndUs = 0;
+static std::string emuLine;
+
+static bool emuStarted = false;
+static bool emuEcho = true;
+static bool gpsOn = false;
+static uint32_t gpsFixAtMs = 0;  // Fix from this time while gpsOn
+static bool emuGprs = true;
+static bool ephemeris = false;   // Receiver holds ephemeris from a fix at ephemerisMs
+static uint32_t ephemerisMs = 0;
+static uint32_t nmeaPeriodMs = 0;
+static uint32_t nextNmeaMs = 0;
+
+// Queue module output starting at startUs, after anything already queued
+static void emu_sendAt(const std::string &text, uint32_t start)
+{
+    if ((int32_t)(emuOutEndUs - start) > 0)
+    {
+        start = emuOutEndUs;
+    }
+    emuOut.push_back({start, text, 0});
+    emuOutEndUs = start + text.size() * EMU_BYTE_US;
+}
+
+static void emu_send(const std::string &text, uint32_t delayMs = 0)
+{
+    emu_sendAt(text, micros() + delayMs * 1000UL);
+}
+
+static bool emu_hasFix(void)
+{
+    if (!gpsOn || (int32_t)(millis() - gpsFixAtMs) < 0)
+    {
+        return false;
+    }
+    ephemeris = true;
+    ephemerisMs = millis();
+    return true;
+}
+
+static void emu_gpsOn(void)
+{
+    if (gpsOn)
+    {
+        return;
+    }
+    bool warm = ephemeris && millis() - ephemerisMs < EMU_EPHEMERIS_MS;
+    gpsFixAtMs = millis() + (warm ? EMU_WARM_MS : EMU_COLD_MS);
+    gpsOn = true;
+}
+
+// ===================================
+// NMEA Output
+// ===================================
+
+static std::string emu_nmea(const char *body)
+{
+    uint8_t sum = 0;
+    for (const char *p = body; *p; p++)
+    {
+        sum ^= (uint8_t)*p;
+    }
+    char tail[8];
+    snprintf(tail, sizeof(tail), "*%02X", sum);
+    return std::string("+GPSRD:$") + body + tail + "\r\n";
+}
+
+// ddmm.mmmm / dddmm.mmmm as NMEA writes them
+static void emu_nmeaCoord(char *out, size_t len, double deg, int degDigits)
+{
+    double a = deg < 0 ? -deg : deg;
+    int d = (int)a;
+    double m = (a - d) * 60.0;
+    snprintf(out, len, "%0*d%07.4f", degDigits, d, m);
+}
+
+static void emu_emitNmea(uint32_t dueMs)
+{
+    uint32_t t = dueMs / 1000;
+    char utc[12];
+    snprintf(utc, sizeof(utc), "%02u%02u%02u.00", (unsigned)(t / 3600 % 24),
+             (unsigned)(t / 60 % 60), (unsigned)(t % 60));
+
+    char lat[16], lon[16], body[96];
+    std::string burst;
+    if (emu_hasFix())
+    {
+        emu_nmeaCoord(lat, sizeof(lat), EMU_LAT, 2);
+        emu_nmeaCoord(lon, sizeof(lon), EMU_LON, 3);
+        snprintf(body, sizeof(body), "GPGGA,%s,%s,N,%s,E,1,08,0.9,%.1f,M,-52.0,M,,", utc, lat, lon, EMU_ALT);
+        burst += emu_nmea(body);
+        snprintf(body, sizeof(body), "GPRMC,%s,A,%s,N,%s,E,0.00,0.00,181026,,,A", utc, lat, lon);
+        burst += emu_nmea(body);
+        burst += emu_nmea("GPGSA,A,3,02,05,07,09,13,16,20,30,,,,,1.6,0.9,1.3");
+        burst += emu_nmea("GPGSV,3,1,11,02,41,312,38,05,22,047,31,07,63,151,44,09,18,276,29");
+        burst += emu_nmea("GPGSV,3,2,11,13,55,082,42,16,12,201,26,20,34,118,35,30,71,004,45");
+        burst += emu_nmea("GPGSV,3,3,11,11,05,330,,18,03,160,,25,08,240,");
+        burst += emu_nmea("GPVTG,0.00,T,,M,0.00,N,0.00,K,A");
+    }
+    else
+    {
+        snprintf(body, sizeof(body), "GPGGA,%s,,,,,0,00,,,M,,M,,", utc);
+        burst += emu_nmea(body);
+        snprintf(body, sizeof(body), "GPRMC,%s,V,,,,,,,181026,,,N", utc);
+        burst += emu_nmea(body);
+        burst += emu_nmea("GPGSA,A,1,,,,,,,,,,,,,,,");
+        burst += emu_nmea("GPGSV,1,1,03,07,63,151,,13,55,082,,30,71,004,");
+    }
+    emu_sendAt(burst, dueMs * 1000UL);
+}
+
+// Bursts missed while the firmware was not polling are sent at the time
+// they were due, so a stalled loop finds them all waiting, as on hardware
+static void emu_tick(void)
+{
+    while (nmeaPeriodMs > 0 && gpsOn && (int32_t)(millis() - nextNmeaMs) >= 0)
+    {
+        emu_emitNmea(nextNmeaMs);
+        nextNmeaMs += nmeaPeriodMs;
+    }
+}
+
+// ===================================
+// AT Commands
+// ===================================
+
+static bool emu_is(const std::string &cmd, const char *name)
+{
+    return cmd.compare(0, strlen(name), name) == 0;
+}
+
+static void emu_command(const std::string &cmd)
+{
+    std::string reply = emuEcho ? cmd + "\r\n" : "";
+    const char *ok = "\r\nOK\r\n";
+
+    if (cmd == "AT")
+    {
+        reply += ok;
+    }
+    else if (cmd == "ATE0" || cmd == "ATE1")
+    {
+        emuEcho = (cmd == "ATE1");
+        reply += ok;
+    }
+    else if (emu_is(cmd, "AT+GPS="))
+    {
+        if (cmd[7] == '1')
+        {
+            emu_gpsOn();
+        }
+        else
+        {
+            gpsOn = false;
+        }
+        reply += ok;
+    }
+    else if (cmd == "AT+GPS?")
+    {
+        reply += gpsOn ? "+GPS: 1\r\n" : "+GPS: 0\r\n";
+        reply += ok;
+    }
+    else if (emu_is(cmd, "AT+GPSRD="))
+    {
+        nmeaPeriodMs = (uint32_t)atoi(cmd.c_str() + 9) * 1000UL;
+        nextNmeaMs = millis() + nmeaPeriodMs;
+        reply += ok;
+    }
+    else if (cmd == "AT+CGATT?")
+    {
+        reply += emuGprs ? "+CGATT: 1\r\n" : "+CGATT: 0\r\n";
+        reply += ok;
+    }
+    else if (cmd == "AT+AGPS=1")
+    {
+        if (!emuGprs)
+        {
+            reply += "+CME ERROR: 58\r\n"; // No network
+            emu_send(reply, EMU_REPLY_MS);
+            return;
+        }
+        // Turns the GPS on; the fix comes soon after the download
+        emu_gpsOn();
+        uint32_t fixAt = millis() + EMU_AGPS_DL_MS + EMU_AGPS_MS;
+        if ((int32_t)(fixAt - gpsFixAtMs) < 0)
+        {
+            gpsFixAtMs = fixAt;
+        }
+        reply += ok;
+        emu_send(reply, EMU_AGPS_DL_MS);
+        return;
+    }
+    else if (emu_is(cmd, "AT+IPR="))
+    {
+        reply += ok; // The emulated link has no baud rate
+    }
+    else if (cmd == "AT+LOCATION=1")
+    {
+        if (!emuGprs)
+        {
+            reply += "+CME ERROR: 58\r\n";
+            emu_send(reply, EMU_REPLY_MS);
+            return;
+        }
+        char pos[48];
+        snprintf(pos, sizeof(pos), "%.6f,%.6f\r\n", EMU_CELL_LAT, EMU_CELL_LON);
+        reply += pos;
+        reply += ok;
+        emu_send(reply, EMU_LBS_MS);
+        return;
+    }
+    else if (cmd == "AT+LOCATION=2")
+    {
+        if (emu_hasFix())
+        {
+            char pos[48];
+            snprintf(pos, sizeof(pos), "%.6f,%.6f\r\n", EMU_LAT, EMU_LON);
+            reply += pos;
+            reply += ok;
+        }
+        else
+        {
+            reply += "+CME ERROR: 516\r\n"; // No fix yet
+        }
+    }
+    else if (cmd == "AT+HTTPACTION=0")
+    {
+        reply += ok;
+        emu_send(reply, EMU_REPLY_MS);
+        emu_send("\r\n+HTTPACTION: 0,200,33\r\n", EMU_HTTP_MS);
+        return;
+    }
+    else if (cmd == "AT+HTTPHEAD")
+    {
+        reply += "+HTTPHEAD: 200,application/json\r\n";
+        reply += ok;
+    }
+    else if (cmd == "AT+HTTPREAD")
+    {
+        reply += "+HTTPREAD: 33\r\n{\"location\": \"New Delhi, Delhi\"}\r\n";
+        reply += ok;
+    }
+    else if (emu_is(cmd, "AT+HTTP"))
+    {
+        reply += ok; // INIT, TERM, PARA
+    }
+    else
+    {
+        reply += "\r\nERROR\r\n";
+    }
+
+    emu_send(reply, EMU_REPLY_MS);
+}
+
+// ===================================
+// Serial1 Interface
+// ===================================
+
+void A9GSerial::begin(unsigned long baud)
+{
+    if (!emuStarted)
+    {
+        emuStarted = true;
+        const char *env = getenv("A9G_EMU_GPRS");
+        emuGprs = (env == NULL || atoi(env) != 0);
+        emu_send("\r\nREADY\r\n", EMU_READY_MS);
+    }
+}
+
+int A9GSerial::available()
+{
+    emu_tick();
+    uint32_t now = micros();
+    int n = 0;
+    for (const EmuChunk &c : emuOut)
+    {
+        if ((int32_t)(now - c.startUs) < 0)
+        {
+            break;
+        }
+        size_t sent = (now - c.startUs) / EMU_BYTE_US + 1;
+        if (sent < c.text.size())
+        {
+            return n + (int)(sent - c.pos);
+        }
+        n += (int)(c.text.size() - c.pos);
+    }
+    return n;
+}
+
+int A9GSerial::read()
+{
+    if (available() == 0)
+    {
+        return -1;
+    }
+    EmuChunk &c = emuOut.front();
+    int ch = (uint8_t)c.text[c.pos++];
+    if (c.pos >= c.text.size())
+    {
+        emuOut.pop_front();
+    }
+    return ch;
+}
+
+size_t A9GSerial::write(uint8_t c)
+{
+    if (c == '\r' || c == '\n')
+    {
+        if (!emuLine.empty())
+        {
+            emu_command(emuLine);
+            emuLine.clear();
+        }
+    }
+    else
+    {
+        emuLine += (char)c;
+    }
+    return 1;
+}
+
+size_t A9GSerial::write(const uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        write(buf[i]);
+    }
+    return len;
+}
+
+void A9GSerial::writeText(const char *s)
+{
+    write((const uint8_t *)s, strlen(s));
+}
@@ -6,13 +6,18 @@
 #include "../main/file_browser.h"
 #include "../main/a9g_gps.h"
 #include "../main/tft_driver.h"
+#include "../main/perf.h"
 
 // SDL bridge functions
 extern void sdl_init();
 extern void sdl_clear(uint16_t);
 extern void sdl_present();
 extern void sdl_drawPixel(int,int,uint16_t);
+extern uint16_t sdl_readPixel(int,int);
 extern bool sdl_touch(int16_t*,int16_t*);
+extern void sdl_setScrollArea(int,int);
+extern void sdl_scrollTo(int);
+extern void sdl_setIdleMode(bool);
 
 
 // ------------------------------------------------
@@ -32,6 +37,13 @@ bool touch_getPoint(int16_t* x,int16_t* y)
     return sdl_touch(x,y);
 }
 
+// PENIRQ stand-in: the mouse button state
+bool touch_irqActive(void)
+{
+    int16_t x, y;
+    return sdl_touch(&x,&y);
+}
+
 
 // ------------------------------------------------
 // TFT DRIVER STUB IMPLEMENTATION
@@ -48,6 +60,11 @@ void tft_init(void)
 
 void tft_setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 {
+    // Same bus traffic as the real driver: CASET/PASET/RAMWR + 8 data bytes
+    PERF_COUNT(windows, 1);
+    PERF_COUNT(commands, 3);
+    PERF_COUNT(spiBytes, 11);
+
     // Save bounds
     _x0 = x0; _y0 = y0;
     _x1 = x1; _y1 = y1;
@@ -56,6 +73,39 @@ void tft_setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
     _cursorY = y0;
 }
 
+static uint16_t _scrollTop = 0, _scrollHeight = SCREEN_HEIGHT, _scrollLine = 0;
+
+void tft_setScrollArea(uint16_t topFixed, uint16_t bottomFixed)
+{
+    _scrollTop = topFixed;
+    _scrollHeight = SCREEN_HEIGHT - topFixed - bottomFixed;
+    PERF_COUNT(commands, 1);
+    PERF_COUNT(spiBytes, 7);
+    sdl_setScrollArea(topFixed, SCREEN_HEIGHT - topFixed - bottomFixed);
+}
+
+void tft_scrollTo(uint16_t line)
+{
+    _scrollLine = line;
+    PERF_COUNT(commands, 1);
+    PERF_COUNT(spiBytes, 3);
+    sdl_scrollTo(line);
+}
+
+void tft_setIdleMode(bool on)
+{
+    PERF_COUNT(commands, 1);
+    PERF_COUNT(spiBytes, 1);
+    sdl_setIdleMode(on);
+}
+
+void tft_getScroll(uint16_t *top, uint16_t *height, uint16_t *line)
+{
+    *top = _scrollTop;
+    *height = _scrollHeight;
+    *line = _scrollLine;
+}
+
 void tft_beginWrite(){}
 void tft_endWrite(){}
 
@@ -72,55 +122,98 @@ void write_pixel_auto_move(uint16_t color) {
 
 void tft_writeColor(uint16_t color)
 {
+    PERF_COUNT(pixels, 1);
+    PERF_COUNT(spiBytes, 2);
     write_pixel_auto_move(color);
 }
 
 void tft_writeData16(uint16_t color)
 {
+    PERF_COUNT(spiBytes, 2);
     write_pixel_auto_move(color);
 }
 
+void tft_beginRead(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    // CASET/PASET/RAMRD + 8 data bytes + the dummy read
+    PERF_COUNT(windows, 1);
+    PERF_COUNT(commands, 3);
+    PERF_COUNT(spiBytes, 12);
+
+    _x0 = x0; _y0 = y0;
+    _x1 = x1; _y1 = y1;
+    _cursorX = x0;
+    _cursorY = y0;
+}
+
+uint16_t tft_readColor(void)
+{
+    PERF_COUNT(spiBytes, 3); // RGB666, one byte per channel
+    uint16_t color = sdl_readPixel(_cursorX, _cursorY);
+
+    _cursorX++;
+    if(_cursorX > _x1) {
+        _cursorX = _x0;
+        _cursorY++;
+    }
+    return color;
+}
+
+void tft_endRead(void){}
+
 
 // ------------------------------------------------
 // FILE BROWSER STUB
 // ------------------------------------------------
 
+// Large enough to exercise the windowed directory and kinetic scrolling
+#define STUB_FILE_COUNT 240
+
 FileBrowser::FileBrowser(){
     // Initialize the member variables that the INLINE getters return
-    fileCount = 5;
+    files = &scratch;
+    windowCapacity = 1;
+    windowStart = 0;
+    windowCount = 0;
+    fileCount = STUB_FILE_COUNT;
     scrollOffset = 0;
     selectedIndex = -1;
-    currentPath = "/";
+    strcpy(currentPath, "/");
+    scanning = false;
 }
 
 bool FileBrowser::begin(uint8_t){ 
-    fileCount = 5;
+    fileCount = STUB_FILE_COUNT;
     return true; 
 }
 
+void FileBrowser::scanRoot(){}
+
 void FileBrowser::openDirectory(const char* path){
-    currentPath = String(path);
+    if (path != currentPath) strcpy(currentPath, path);
     // Reset fake files on directory change
-    fileCount = 5;
+    fileCount = STUB_FILE_COUNT;
     scrollOffset = 0;
     selectedIndex = -1;
 }
 
 FileEntry* FileBrowser::getFile(int i)
 {
-    // Access the private 'files' array directly since we are in the class scope
-    if (i < 0 || i >= MAX_FILES_DISPLAY) return nullptr;
+    if (i < 0 || i >= fileCount) return nullptr;
+
+    // Fake the window: entries are generated into a rotating slot
+    FileEntry* entry = &files[i % windowCapacity];
 
     // Generate some fake filenames based on index
-    if (i == 0) strcpy(files[i].name, "data_log.csv");
-    else if (i == 1) strcpy(files[i].name, "config.ini");
-    else if (i == 2) strcpy(files[i].name, "images"); // Directory
-    else sprintf(files[i].name, "record_%02d.txt", i);
+    if (i == 0) strcpy(entry->name, "data_log.csv");
+    else if (i == 1) strcpy(entry->name, "config.ini");
+    else if (i == 2) strcpy(entry->name, "images"); // Directory
+    else sprintf(entry->name, "record_%03d.txt", i);
 
-    files[i].isDirectory = (i == 2); // Make index 2 a folder
-    files[i].size = 1024 * (i + 1);
+    entry->isDirectory = (i == 2); // Make index 2 a folder
+    entry->size = 1024 * (i + 1);
 
-    return &files[i];
+    return entry;
 }
 
 void FileBrowser::scroll(int delta){
@@ -130,8 +223,8 @@ void FileBrowser::scroll(int delta){
 }
 
 void FileBrowser::goUp(){
-    if(currentPath.length() > 1) {
-        currentPath = "/";
+    if(canGoUp()) {
+        strcpy(currentPath, "/");
         openDirectory("/");
     }
 }
@@ -140,40 +233,13 @@ void FileBrowser::selectFile(int i){
     selectedIndex = i;
 }
 
-
-// ------------------------------------------------
-// GPS STUB
-// ------------------------------------------------
-
-A9G_GPS::A9G_GPS(){}
-
-bool A9G_GPS::begin(){ return true; }
-
-void A9G_GPS::update(){} 
-
-GPSData A9G_GPS::getGPSData()
-{
-    GPSData d{};
-    d.valid = true;
-    d.latitude = 28.6139; // New Delhi Lat
-    d.longitude = 77.2090; // New Delhi Lon
-    d.satellites = 5;
-    d.altitude = 210.5;
-    return d;
+void FileBrowser::attachWindow(FileEntry* buffer, int capacity){
+    if (!buffer || capacity < 1) return;
+    files = buffer;
+    windowCapacity = capacity;
 }
 
-GPSDebugInfo A9G_GPS::getDebugInfo()
-{
-    GPSDebugInfo i{};
-    strcpy(i.lastCommand, "AT+GPS=1");
-    strcpy(i.gpsStatus, "3D Fix");
-    strcpy(i.locationResponse, "28.6139,77.2090");
-    i.fixAttempts = 1;
-    i.lastUpdateTime = 12345;
-    return i;
-}
-
-void A9G_GPS::refreshDebugInfo(){}
-void A9G_GPS::turnOnGPS(){}
-void A9G_GPS::turnOffGPS(){}
-// Removed the invalid setGPS functions
\ No newline at end of file
+void FileBrowser::detachWindow(){
+    files = &scratch;
+    windowCapacity = 1;
+}
@@ -6,12 +6,37 @@
 #include "../main/ui_engine.cpp"
 #include "../main/screens.cpp"
 #include "../main/drawing.cpp"
+#include "../main/input.cpp"
+#include "../main/scheduler.cpp"
+#include "../main/perf.cpp"
+#include "../main/power.cpp"
 #include "../main/tft_driver.h"
+#include "../main/a9g_gps.h"
+#include "../main/workqueue.h"
 
 // SDL hooks
 extern void sdl_init();
 extern void sdl_present();
-extern bool touch_getPoint(int16_t*, int16_t*);
+
+extern A9G_GPS gpsModule;
+
+static void simFrame()
+{
+    ui_update();
+    sdl_present();
+}
+
+// Same GPS tasks as the firmware, talking to the A9G emulator
+static void simGPSPoll()
+{
+    gpsModule.update();
+}
+
+static void simGPSDisplay()
+{
+    const GPSData *gpsData = gpsModule.getGPSData();
+    ui_setGPSCoordinates(gpsData->latE7, gpsData->lonE7, gpsData->valid);
+}
 
 int main()
 {
@@ -29,16 +54,33 @@ int main()
     // Draw once
     ui_drawScreen();
 
+    // The emulator boots as slowly as the real module, in the background
+    gpsModule.begin();
+
+    // Same task layout as the firmware's UI side
+    sched_addTask("ui", simFrame, UI_FRAME_MS * 1000UL, 12000, TASK_PRIO_UI);
+    sched_addTask("touch", input_poll, TOUCH_SAMPLE_MS * 1000UL, 300, TASK_PRIO_UI);
+    sched_addTask("gps", simGPSPoll, GPS_POLL_MS * 1000UL, 2000, TASK_PRIO_NORMAL);
+    sched_addTask("gps-ui", simGPSDisplay, GPS_UI_REFRESH_MS * 1000UL, 1000, TASK_PRIO_LOW);
+    sched_addTask("power", power_report, POWER_REPORT_MS * 1000UL, 1000, TASK_PRIO_LOW);
+#if PERF_ENABLED
+    sched_addTask("perf", perf_report, PERF_REPORT_MS * 1000UL, 3000, TASK_PRIO_LOW);
+#endif
+
     // ---------- Loop ----------
     while(true)
     {
-        int16_t x,y;
-        if(touch_getPoint(&x,&y))
-            ui_handleTouch(x,y);
-
-        ui_update();
-        sdl_present();
-        SDL_Delay(16);
+        if (!sched_run())
+        {
+            if (work_pending())
+            {
+                work_idle(sched_slackUs());
+            }
+            else
+            {
+                power_idle(sched_slackUs());
+            }
+        }
     }
 
     return 0;
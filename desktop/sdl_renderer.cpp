@@ -12,6 +12,15 @@ static const int H = 320;
 // Framebuffer (RGB888)
 static uint32_t framebuffer[W * H];
 
+// Hardware vertical scroll emulation (framebuffer acts as display RAM)
+static int scroll_top = 0;
+static int scroll_height = H;
+static int scroll_start = 0;
+
+// Panel idle mode (8 colors) and whether anything changed since the last present
+static bool idle_mode = false;
+static bool dirty = true;
+
 // State for mouse/touch
 static bool is_mouse_down = false;
 static int mouse_x = 0;
@@ -63,6 +72,7 @@ void sdl_clear(uint16_t color565)
     uint32_t col = rgb565_to_888(color565);
     for(int i=0;i<W*H;i++)
         framebuffer[i] = col;
+    dirty = true;
 }
 
 
@@ -72,11 +82,64 @@ void sdl_drawPixel(int x, int y, uint16_t color565)
         return;
 
     framebuffer[y * W + x] = rgb565_to_888(color565);
+    dirty = true;
+}
+
+
+// Read display RAM back (RAMRD), 888 -> 565 is exact for 565-sourced pixels
+uint16_t sdl_readPixel(int x, int y)
+{
+    if(x < 0 || x >= W || y < 0 || y >= H)
+        return 0;
+
+    uint32_t c = framebuffer[y * W + x];
+    return (uint16_t)((((c >> 16) & 0xF8) << 8) | (((c >> 8) & 0xFC) << 3) | ((c & 0xFF) >> 3));
 }
 
 
+void sdl_setScrollArea(int top, int height)
+{
+    scroll_top = top;
+    scroll_height = height;
+    dirty = true;
+}
+
+void sdl_scrollTo(int line)
+{
+    scroll_start = line;
+    dirty = true;
+}
+
+void sdl_setIdleMode(bool on)
+{
+    idle_mode = on;
+    dirty = true;
+}
+
+// Map display RAM to the panel the way VSCRDEF/VSCRSADD do
+static const uint32_t* sdl_scanout()
+{
+    static uint32_t scanout[W * H];
+
+    if (scroll_start == scroll_top || scroll_height <= 0)
+        return framebuffer;
+
+    memcpy(scanout, framebuffer, sizeof(scanout));
+    for (int line = 0; line < scroll_height; line++) {
+        int src = scroll_top + (line + scroll_start - scroll_top + scroll_height) % scroll_height;
+        if (src < 0 || src >= H) continue;
+        memcpy(&scanout[(scroll_top + line) * W], &framebuffer[src * W], W * 4);
+    }
+    return scanout;
+}
+
 void sdl_present()
 {
+    // Frame skip: nothing was drawn or scrolled since the last present
+    if (!dirty)
+        return;
+    dirty = false;
+
     SDL_Texture* tex = SDL_CreateTexture(
         renderer,
         SDL_PIXELFORMAT_ARGB8888,
@@ -84,7 +147,20 @@ void sdl_present()
         W, H
     );
 
-    SDL_UpdateTexture(tex, nullptr, framebuffer, W * 4);
+    const uint32_t* pixels = sdl_scanout();
+    if (idle_mode) {
+        // Idle mode keeps only the MSB of each channel
+        static uint32_t idle_pixels[W * H];
+        for (int i = 0; i < W * H; i++) {
+            uint32_t c = pixels[i];
+            idle_pixels[i] = 0xFF000000 |
+                             ((c & 0x800000) ? 0xFF0000 : 0) |
+                             ((c & 0x008000) ? 0x00FF00 : 0) |
+                             ((c & 0x000080) ? 0x0000FF : 0);
+        }
+        pixels = idle_pixels;
+    }
+    SDL_UpdateTexture(tex, nullptr, pixels, W * 4);
 
     SDL_RenderClear(renderer);
     SDL_RenderCopy(renderer, tex, nullptr, nullptr);
@@ -9,16 +9,11 @@
 A9G_GPS::A9G_GPS()
 {
     moduleOn = false;
-    gpsData.valid = false;
-    gpsData.latitude = 0.0;
-    gpsData.longitude = 0.0;
-    gpsData.altitude = 0.0;
-    gpsData.satellites = 0;
+    memset(&gpsData, 0, sizeof(gpsData));
     gpsData.latDirection = 'N';
     gpsData.lonDirection = 'E';
     strcpy(gpsData.lastUpdate, "No Fix");
-    lastGPSRead = 0;
-    gpsReadInterval = 5000; // Read GPS every 5 seconds
+    nmea_init(&nmea);
 
     // Initialize debug info
     strcpy(debugInfo.lastCommand, "None");
@@ -28,16 +23,74 @@ A9G_GPS::A9G_GPS()
     debugInfo.lastUpdateTime = 0;
     debugInfo.fixAttempts = 0;
 
-    // Initialize NMEA buffer
-    nmeaBuffer.writeIndex = 0;
-    nmeaBuffer.count = 0;
-    for (int i = 0; i < NMEA_BUFFER_SIZE; i++)
-    {
-        nmeaBuffer.sentences[i][0] = '\0';
-    }
+    nmeaHistory = NULL;
+    locationPending = false;
+    memset(&cellFix, 0, sizeof(cellFix));
+    cellPending = false;
+    cellNextMs = 0;
+    httpStep = A9G_HTTP_IDLE;
+    strcpy(locationName, "Unknown");
+    cacheName[0] = '\0';
+    logCount = 0;
+    logSyncDue = false;
+    track_simplifyInit(&trackFilter, TRACK_SIMPLIFY_CM);
+    bootState = A9G_BOOT_OFF;
+    memset(seq, 0, sizeof(seq));
+
+    memset(&power, 0, sizeof(power));
+    power.mode = GPS_MODE_OFF;
+    power.reason = "boot";
+    policyMs = 0;
+    holdUntilMs = 0;
+    modePending = false;
+    stillValid = false;
+    wakeCheck = false;
+    hadFix = false;
+    agpsPending = false;
+    lastFixValid = false;
+    lastFixLoaded = false;
+    lastFixDirty = false;
+    lastFixDue = false;
+    lastSaveMs = 0;
 }
 
-bool A9G_GPS::begin()
+typedef struct
+{
+    const char *cmd;
+    uint32_t timeoutMs;
+    const char *urc; // Completes on this URC after "OK" (NULL = on "OK")
+} A9GCommand;
+
+// GPS enable sequence sent once the module answers "AT"
+static const A9GCommand gpsInitCommands[] = {
+    {"AT+GPS=1", 2000, NULL},
+    {"AT+GPS?", 1000, NULL},
+    {"AT+GPSRD=1", 1000, NULL}, // NMEA output every 1 second for faster updates
+};
+#define GPS_INIT_COMMAND_COUNT (sizeof(gpsInitCommands) / sizeof(gpsInitCommands[0]))
+
+// Place name lookup; a NULL command is the URL, built from the fix
+static const A9GCommand httpCommands[] = {
+    {"AT+HTTPTERM", 2000, NULL}, // Close any existing connection
+    {"AT+HTTPINIT", 3000, NULL},
+    {"AT+HTTPPARA=\"CID\",1", 2000, NULL},
+    {NULL, 2000, NULL},
+    {"AT+HTTPPARA=\"CONTENT\",\"application/json\"", 2000, NULL},
+    {"AT+HTTPACTION=0", 15000, "+HTTPACTION:"}, // 0 = GET
+    {"AT+HTTPHEAD", 3000, NULL},
+    {"AT+HTTPREAD", 5000, NULL},
+    {"AT+HTTPTERM", 2000, NULL},
+};
+#define HTTP_COMMAND_COUNT (sizeof(httpCommands) / sizeof(httpCommands[0]))
+enum
+{
+    HTTP_STEP_INIT = 1,
+    HTTP_STEP_ACTION = 5,
+    HTTP_STEP_HEAD = 6,
+    HTTP_STEP_READ = 7
+};
+
+void A9G_GPS::begin()
 {
     // Setup control pins
     pinMode(A9G_PWR_KEY, OUTPUT);
@@ -48,239 +101,826 @@ bool A9G_GPS::begin()
     digitalWrite(A9G_LOW_PWR_KEY, HIGH);
     digitalWrite(A9G_PWR_KEY, HIGH);
 
-    // Initialize Serial1 for A9G communication
-    Serial1.begin(115200);
+    // Initialize Serial1 for A9G communication; received bytes go to the
+    // DMA ring that at_poll() reads
+    uart_begin(115200);
+    at_setHandlers(onNmea, onUrc, this);
 
     SerialUSB.println(F("A9G: Initializing module..."));
 
-    // Power on sequence
+    // Power on sequence; update() releases the key and probes the module
     digitalWrite(A9G_PWR_KEY, LOW);
-    delay(3000);
-    digitalWrite(A9G_PWR_KEY, HIGH);
-    delay(5000);
+    bootState = A9G_BOOT_PWR_PULSE;
+    bootMs = millis();
+    bootTries = 1;
+    setStatus("Powering up");
+}
 
-    // Check if module is on
-    moduleOn = checkModuleState();
+bool A9G_GPS::isBooting()
+{
+    return bootState != A9G_BOOT_READY && bootState != A9G_BOOT_FAILED;
+}
 
-    if (!moduleOn)
+const char *A9G_GPS::getBootStage()
+{
+    switch (bootState)
     {
-        SerialUSB.println(F("A9G: Module off, turning on..."));
-        digitalWrite(A9G_PWR_KEY, LOW);
-        delay(3000);
-        digitalWrite(A9G_PWR_KEY, HIGH);
-        delay(5000);
-        moduleOn = checkModuleState();
+    case A9G_BOOT_OFF:
+    case A9G_BOOT_PWR_PULSE:
+    case A9G_BOOT_PWR_SETTLE:
+        return "GPS power";
+    case A9G_BOOT_PROBE:
+    case A9G_BOOT_PROBE_GAP:
+        return "GPS probe";
+    case A9G_BOOT_GPS_INIT:
+        return "GPS start";
+    default:
+        return NULL;
+    }
+}
+
+// One step of the power-up sequence. The pulse and settle stages only
+// check the clock; replies to the probe and GPS commands arrive in
+// onProbeReply() and onInitReply() from at_poll()
+void A9G_GPS::bootStep()
+{
+    unsigned long elapsed = millis() - bootMs;
+
+    switch (bootState)
+    {
+    case A9G_BOOT_PWR_PULSE:
+        if (elapsed >= A9G_PWR_PULSE_MS)
+        {
+            digitalWrite(A9G_PWR_KEY, HIGH);
+            bootState = A9G_BOOT_PWR_SETTLE;
+            bootMs = millis();
+        }
+        break;
+
+    case A9G_BOOT_PWR_SETTLE:
+        if (elapsed >= A9G_PWR_SETTLE_MS)
+        {
+            bootProbes = 0;
+            bootState = A9G_BOOT_PROBE;
+            command("AT", A9G_PROBE_TIMEOUT_MS, onProbeReply);
+        }
+        break;
+
+    case A9G_BOOT_PROBE_GAP:
+        if (elapsed >= A9G_PROBE_GAP_MS)
+        {
+            bootState = A9G_BOOT_PROBE;
+            command("AT", A9G_PROBE_TIMEOUT_MS, onProbeReply);
+        }
+        break;
+
+    default:
+        break;
     }
+}
 
-    if (moduleOn)
+void A9G_GPS::onProbeReply(void *ctx, AtResult result, const char *response)
+{
+    (void)response; // Only whether "AT" was answered
+    A9G_GPS *gps = (A9G_GPS *)ctx;
+
+    if (result == AT_OK)
     {
+        SerialUSB.println(F("A9G: Module responding"));
         SerialUSB.println(F("A9G: Module ready!"));
-        turnOnGPS();
-        strcpy(debugInfo.gpsStatus, "Module Ready");
-        return true;
+        SerialUSB.println(F("A9G: Turning on GPS..."));
+        gps->moduleOn = true;
+        gps->bootCmd = 0;
+        gps->bootState = A9G_BOOT_GPS_INIT;
+        gps->power.mode = GPS_MODE_TRACK;
+        gps->power.modeSinceMs = millis();
+        gps->startAcquire();
+        for (uint8_t i = 0; i < GPS_INIT_COMMAND_COUNT; i++)
+        {
+            gps->command(gpsInitCommands[i].cmd, gpsInitCommands[i].timeoutMs, onInitReply);
+        }
+    }
+    else if (++gps->bootProbes < A9G_PROBE_TRIES)
+    {
+        gps->bootState = A9G_BOOT_PROBE_GAP;
+        gps->bootMs = millis();
+    }
+    else if (gps->bootTries < A9G_POWER_TRIES)
+    {
+        SerialUSB.println(F("A9G: Module off, turning on..."));
+        digitalWrite(A9G_PWR_KEY, LOW);
+        gps->bootTries++;
+        gps->bootState = A9G_BOOT_PWR_PULSE;
+        gps->bootMs = millis();
     }
     else
     {
         SerialUSB.println(F("A9G: Failed to initialize!"));
-        strcpy(debugInfo.gpsStatus, "Init Failed");
-        return false;
+        gps->setStatus("Init Failed");
+        gps->bootState = A9G_BOOT_FAILED;
     }
 }
 
-bool A9G_GPS::checkModuleState()
+void A9G_GPS::onInitReply(void *ctx, AtResult result, const char *response)
 {
-    for (int i = 0; i < 5; i++)
+    A9G_GPS *gps = (A9G_GPS *)ctx;
+
+    onPrintReply(ctx, result, response);
+    if (++gps->bootCmd < GPS_INIT_COMMAND_COUNT)
     {
-        String response = sendCommand("AT", 1000);
-        if (response.indexOf("OK") >= 0)
-        {
-            SerialUSB.println(F("A9G: Module responding"));
-            return true;
-        }
-        delay(500);
+        return;
+    }
+
+    SerialUSB.println(F("GPS initialization complete. Waiting for satellite fix..."));
+    SerialUSB.println(F("Note: GPS may take 30-60 seconds for first fix. Needs clear sky view."));
+    gps->setStatus("Module Ready");
+    gps->bootState = A9G_BOOT_READY;
+    gps->policyMs = millis();
+
+    // The card is mounted by now; read back the fix saved before the reboot
+    work_submit("gps-last", lastFixWork, gps);
+
+#if A9G_FAST_BAUD
+    // The link works at the default rate; move it up. Not saved with
+    // AT&W, so a power cycle brings the module back to 115200.
+    char cmd[24];
+    snprintf(cmd, sizeof(cmd), "AT+IPR=%lu", (unsigned long)A9G_FAST_BAUD);
+    gps->command(cmd, 1000, onBaudReply);
+#endif
+}
+
+void A9G_GPS::onBaudReply(void *ctx, AtResult result, const char *response)
+{
+    onPrintReply(ctx, result, response);
+    if (result == AT_OK)
+    {
+        // "OK" came at the old rate; the module switches after sending it
+        uart_setBaud(A9G_FAST_BAUD);
     }
-    return false;
 }
 
 void A9G_GPS::turnOnGPS()
 {
+    if (isBooting())
+    {
+        return; // The boot sequence enables GPS itself
+    }
     SerialUSB.println(F("A9G: Turning on GPS..."));
+    requestFix();
+}
 
-    // Turn on GPS
-    String response = sendCommand("AT+GPS=1", 2000);
-    SerialUSB.print(F("GPS ON Response: "));
-    SerialUSB.println(response);
+void A9G_GPS::turnOffGPS()
+{
+    if (isBooting())
+    {
+        return;
+    }
+    SerialUSB.println(F("A9G: Turning off GPS..."));
+    holdUntilMs = millis();
+    setMode(GPS_MODE_OFF, "user");
+}
 
-    // Check GPS status
-    String status = sendCommand("AT+GPS?", 1000);
-    SerialUSB.print(F("GPS Status: "));
-    SerialUSB.println(status);
+// ===================================
+// Receiver Duty Cycle
+// ===================================
 
-    // Enable NMEA output every 1 second for faster updates
-    sendCommand("AT+GPSRD=1", 1000);
+// Replies are printed by onPrintReply() as they arrive. The mode only
+// changes once all its commands are queued; without room in the AT queue
+// it is kept in modePending and update() tries again.
+void A9G_GPS::setMode(GPSPowerMode mode, const char *reason)
+{
+    modePending = false;
+    if (mode == power.mode)
+    {
+        return;
+    }
+    uint8_t needed = (mode == GPS_MODE_OFF || power.mode == GPS_MODE_OFF) ? 2 : 1;
+    if (at_free() < needed)
+    {
+        modePending = true;
+        pendingMode = mode;
+        pendingReason = reason;
+        return;
+    }
 
-    SerialUSB.println(F("GPS initialization complete. Waiting for satellite fix..."));
-    SerialUSB.println(F("Note: GPS may take 30-60 seconds for first fix. Needs clear sky view."));
+    if (mode == GPS_MODE_OFF)
+    {
+        command("AT+GPSRD=0", 1000, onPrintReply);
+        command("AT+GPS=0", 2000, onPrintReply);
+        if (power.acquiring)
+        {
+            power.acquiring = false;
+            power.ttffFails++;
+        }
+        saveLastFix();
+        endTrack();
+    }
+    else
+    {
+        if (power.mode == GPS_MODE_OFF)
+        {
+            command("AT+GPS=1", 2000, onPrintReply);
+            startAcquire();
+        }
+        char cmd[16];
+        snprintf(cmd, sizeof(cmd), "AT+GPSRD=%d", (mode == GPS_MODE_SLOW) ? GPS_SLOW_RD_S : 1);
+        command(cmd, 1000, onPrintReply);
+    }
+
+    static const char *const modeNames[] = {"TRACK", "SLOW", "OFF"};
+    SerialUSB.print(F("GPS mode: "));
+    SerialUSB.print(modeNames[mode]);
+    SerialUSB.print(F(" ("));
+    SerialUSB.print(reason);
+    SerialUSB.println(F(")"));
+
+    power.mode = mode;
+    power.reason = reason;
+    power.modeSinceMs = millis();
+    seq[GPS_SEQ_POWER]++;
 }
 
-void A9G_GPS::turnOffGPS()
+// Receiver just powered on. The GNSS engine keeps its ephemeris while
+// the module has power, so a recent fix means a warm start; a cold one
+// asks for AGPS from powerPolicy() once GPRS is attached.
+void A9G_GPS::startAcquire()
 {
-    SerialUSB.println(F("A9G: Turning off GPS..."));
-    sendCommand("AT+GPS=0", 2000);
+    unsigned long now = millis();
+    power.acquiring = true;
+    power.acquireMs = now;
+    power.start = (hadFix && now - lastFixMs < GPS_WARM_MAX_MS) ? GPS_START_WARM : GPS_START_COLD;
+    agpsTried = false;
+    agpsCheckMs = now - GPS_AGPS_RETRY_MS;
+    seq[GPS_SEQ_POWER]++;
 }
 
-void A9G_GPS::refreshDebugInfo()
+// A fix from the NMEA stream; the first after power-on ends acquisition
+void A9G_GPS::noteFix()
 {
-    SerialUSB.println(F("Refreshing GPS..."));
-
-    // Check GPS status first
-    String status = sendCommand("AT+GPS?", 1000);
-    SerialUSB.print(F("GPS Status: "));
-    SerialUSB.println(status);
+    unsigned long now = millis();
+    hadFix = true;
+    lastFixMs = now;
+    cellFix.source = GPS_LOC_NONE; // Superseded
 
-    // Get location
-    String location = sendCommand("AT+LOCATION=2", 2000);
-    SerialUSB.print(F("Location: "));
-    SerialUSB.println(location);
+    if (power.acquiring)
+    {
+        GPSTtff *t = &power.ttff[power.start];
+        uint32_t ttff = now - power.acquireMs;
+        power.acquiring = false;
+        t->lastMs = ttff;
+        if (t->count == 0 || ttff < t->minMs)
+        {
+            t->minMs = ttff;
+        }
+        if (ttff > t->maxMs)
+        {
+            t->maxMs = ttff;
+        }
+        t->count++;
+        seq[GPS_SEQ_POWER]++;
+        lastFixDue = true;
+    }
+    if (lastFixDue || now - lastSaveMs >= GPS_LAST_SAVE_MS)
+    {
+        saveLastFix();
+    }
 }
 
-void A9G_GPS::update()
+// Movement is judged from the fixes themselves: the device has no other
+// motion sensor. Stationary with a good fix, the receiver steps down to
+// SLOW and then OFF; it wakes every GPS_OFF_MS to look again.
+void A9G_GPS::powerPolicy()
 {
-    // Read GPS data periodically (simple approach like reference)
-    if (millis() - lastGPSRead > gpsReadInterval)
+    unsigned long now = millis();
+    uint32_t elapsed = now - policyMs;
+    policyMs = now;
+    power.upMs += elapsed;
+    if (power.mode != GPS_MODE_OFF)
+    {
+        power.onMs += elapsed;
+    }
+
+    if (power.mode == GPS_MODE_OFF)
     {
-        // Get location - simple command
-        String response = sendCommand("AT+LOCATION=2", 2000);
+        if (now - power.modeSinceMs >= GPS_OFF_MS)
+        {
+            wakeCheck = true;
+            setMode(GPS_MODE_TRACK, "wake check");
+        }
+        return;
+    }
 
-        // Simple parsing: just look for lat,lon pattern
-        if (response.indexOf(",") > 0 && response.indexOf("OK") > 0)
+    bool held = (int32_t)(holdUntilMs - now) > 0;
+    if (power.acquiring)
+    {
+#if GPS_AGPS
+        // AGPS needs the packet network, which may attach after the GPS is on
+        if (power.start == GPS_START_COLD && !agpsTried && !agpsPending &&
+            now - agpsCheckMs >= GPS_AGPS_RETRY_MS)
         {
-            // Got valid response with coordinates
-            parseGPSLocation(response);
-            logGPSData(); // Log to SD card
+            agpsCheckMs = now;
+            agpsPending = command("AT+CGATT?", 1000, onGprsReply);
         }
-        else
+#endif
+        if (now - power.acquireMs >= GPS_ACQUIRE_MS && !held)
         {
-            // No fix or error
-            gpsData.valid = false;
+            setMode(GPS_MODE_OFF, "no fix");
         }
+        return;
+    }
+    if (!gpsData.valid)
+    {
+        return; // Fix lost; keep listening at the current rate
+    }
 
-        lastGPSRead = millis();
+    bool moved = !stillValid || gpsData.speedKmh >= GPS_MOVE_KMH ||
+                 geo_distanceM(stillLatE7, stillLonE7, gpsData.latE7, gpsData.lonE7) > GPS_STILL_M;
+    if (moved)
+    {
+        stillLatE7 = gpsData.latE7;
+        stillLonE7 = gpsData.lonE7;
+        stillSinceMs = now;
+        stillValid = true;
+        wakeCheck = false;
+        setMode(GPS_MODE_TRACK, "moving");
+        return;
     }
 
-    // Process any incoming NMEA data for display only
-    while (Serial1.available() > 0)
+    bool good = gpsData.hdop <= GPS_GOOD_HDOP && gpsData.satellites >= GPS_GOOD_SATS;
+    if (wakeCheck && good)
+    {
+        wakeCheck = false;
+        setMode(GPS_MODE_OFF, "not moved");
+        return;
+    }
+    if (held)
+    {
+        return;
+    }
+
+    uint32_t stillFor = now - stillSinceMs;
+    if (good && stillFor >= GPS_SLEEP_MS)
+    {
+        setMode(GPS_MODE_OFF, "stationary");
+    }
+    else if (power.mode == GPS_MODE_TRACK && stillFor >= GPS_STILL_MS)
     {
-        char c = Serial1.read();
-        static String nmeaBuf = "";
-        nmeaBuf += c;
+        setMode(GPS_MODE_SLOW, "stationary");
+    }
+}
+
+void A9G_GPS::requestFix()
+{
+    holdUntilMs = millis() + GPS_USER_HOLD_MS;
+    wakeCheck = false;
+    setMode(GPS_MODE_TRACK, "requested");
+}
 
-        if (c == '\n')
+const GPSPowerInfo *A9G_GPS::getPowerInfo()
+{
+    return &power;
+}
+
+void A9G_GPS::printPowerStats()
+{
+    static const char *const modeNames[] = {"TRACK", "SLOW", "OFF"};
+    static const char *const startNames[] = {"cold", "warm", "agps"};
+    char line[96];
+    uint32_t onPct = power.upMs ? (uint32_t)((uint64_t)power.onMs * 100 / power.upMs) : 100;
+    snprintf(line, sizeof(line), "gps mode=%s on=%lu%% fail=%u agpsFail=%u", modeNames[power.mode],
+             (unsigned long)onPct, power.ttffFails, power.agpsFails);
+    SerialUSB.println(line);
+    for (uint8_t k = 0; k < GPS_START_KINDS; k++)
+    {
+        const GPSTtff *t = &power.ttff[k];
+        if (t->count == 0)
         {
-            // Just store NMEA sentences for display
-            if (nmeaBuf.indexOf("$GP") >= 0 || nmeaBuf.indexOf("$GN") >= 0)
+            continue;
+        }
+        snprintf(line, sizeof(line), "   ttff %s n=%u last=%lums min=%lums max=%lums", startNames[k],
+                 t->count, (unsigned long)t->lastMs, (unsigned long)t->minMs, (unsigned long)t->maxMs);
+        SerialUSB.println(line);
+    }
+    if (lastFixValid)
+    {
+        int n = snprintf(line, sizeof(line), "   last fix t=%lu ", (unsigned long)lastFix.time);
+        n += geo_formatE7(line + n, sizeof(line) - n, lastFix.latE7, 6);
+        line[n++] = ',';
+        geo_formatE7(line + n, sizeof(line) - n, lastFix.lonE7, 6);
+        SerialUSB.println(line);
+    }
+}
+
+// ===================================
+// Last Fix and AGPS
+// ===================================
+
+const TrackPoint *A9G_GPS::getLastFix()
+{
+    return lastFixValid ? &lastFix : NULL;
+}
+
+// Keep the current fix for the next boot; written from the work queue
+void A9G_GPS::saveLastFix()
+{
+    uint32_t time = nmea_seconds(&gpsData);
+    if (!gpsData.valid || time == 0 || (lastFixValid && time == lastFix.time))
+    {
+        return; // RMC has not supplied the date yet, or nothing new
+    }
+    lastFixDue = false;
+    lastFix.time = time;
+    lastFix.latE7 = gpsData.latE7;
+    lastFix.lonE7 = gpsData.lonE7;
+    lastFix.altM = (int16_t)gpsData.altitude;
+    lastFixValid = true;
+    lastFixDirty = true;
+    lastSaveMs = millis();
+    work_submit("gps-last", lastFixWork, this);
+}
+
+WorkStatus A9G_GPS::lastFixWork(void *ctx, uint32_t deadlineUs)
+{
+    (void)deadlineUs; // One short read or write
+    A9G_GPS *gps = (A9G_GPS *)ctx;
+    char line[48];
+
+    if (!gps->lastFixLoaded)
+    {
+        gps->lastFixLoaded = true;
+        File file = SD.open(GPS_LAST_FILE, FILE_READ);
+        if (file && !gps->lastFixValid)
+        {
+            int n = file.read(line, sizeof(line) - 1);
+            line[(n > 0) ? n : 0] = '\0';
+
+            // "seconds,lat,lon,alt"
+            char *end;
+            TrackPoint fix;
+            fix.time = strtoul(line, &end, 10);
+            const char *p = end;
+            bool ok = fix.time != 0 && *p == ',';
+            if (ok)
+            {
+                fix.latE7 = geo_parseE7(p + 1, &p);
+                ok = *p == ',';
+            }
+            if (ok)
+            {
+                fix.lonE7 = geo_parseE7(p + 1, &p);
+                ok = *p == ',';
+            }
+            if (ok)
             {
-                addNMEASentence(nmeaBuf.c_str());
+                fix.altM = (int16_t)atoi(p + 1);
+                gps->lastFix = fix;
+                gps->lastFixValid = true;
+                SerialUSB.print(F("GPS: last fix from SD, t="));
+                SerialUSB.println(fix.time);
             }
-            nmeaBuf = "";
+        }
+        if (file)
+        {
+            file.close();
         }
     }
+
+    if (gps->lastFixDirty)
+    {
+        gps->lastFixDirty = false;
+        int n = snprintf(line, sizeof(line), "%lu,", (unsigned long)gps->lastFix.time);
+        n += geo_formatE7(line + n, sizeof(line) - n, gps->lastFix.latE7, 7);
+        line[n++] = ',';
+        n += geo_formatE7(line + n, sizeof(line) - n, gps->lastFix.lonE7, 7);
+        n += snprintf(line + n, sizeof(line) - n, ",%d\n", gps->lastFix.altM);
+
+        File file = SD.open(GPS_LAST_FILE, O_WRITE | O_CREAT | O_TRUNC);
+        if (file)
+        {
+            file.write((const uint8_t *)line, n);
+            file.close();
+        }
+    }
+    return WORK_DONE;
 }
 
-void A9G_GPS::parseGPSLocation(String response)
+// Cold start: fetch ephemeris over GPRS once the module is attached
+void A9G_GPS::onGprsReply(void *ctx, AtResult result, const char *response)
 {
-    // Simple parsing - just extract lat,lon from response
-    // Response format: "lat,lon\n\nOK" or "+LOCATION: lat,lon,date,time"
-
-    String locData = response;
+    A9G_GPS *gps = (A9G_GPS *)ctx;
+    gps->noteResponse(response);
+    gps->agpsPending = false;
 
-    // Remove everything after "OK"
-    int okIdx = locData.indexOf("OK");
-    if (okIdx > 0)
+    const char *state = strstr(response, "+CGATT:");
+    if (result == AT_OK && state != NULL && atoi(state + 7) == 1 && gps->power.acquiring)
     {
-        locData = locData.substring(0, okIdx);
+        SerialUSB.println(F("GPS: GPRS attached, requesting AGPS"));
+        gps->agpsTried = true;
+        gps->agpsPending = gps->command("AT+AGPS=1", GPS_AGPS_TIMEOUT_MS, onAgpsReply);
     }
+}
+
+void A9G_GPS::onAgpsReply(void *ctx, AtResult result, const char *response)
+{
+    A9G_GPS *gps = (A9G_GPS *)ctx;
+    onPrintReply(ctx, result, response);
+    gps->agpsPending = false;
 
-    // If has "+LOCATION:", skip it
-    int locIdx = locData.indexOf("+LOCATION:");
-    if (locIdx >= 0)
+    if (result != AT_OK)
     {
-        locData = locData.substring(locIdx + 10);
+        gps->power.agpsFails++;
     }
+    else if (gps->power.acquiring)
+    {
+        gps->power.start = GPS_START_ASSISTED;
+    }
+    gps->seq[GPS_SEQ_POWER]++;
+}
 
-    // Clean up
-    locData.trim();
-    locData.replace("\r", "");
-    locData.replace("\n", "");
+void A9G_GPS::refreshDebugInfo()
+{
+    if (isBooting())
+    {
+        return;
+    }
+    SerialUSB.println(F("Refreshing GPS..."));
 
-    // Parse: lat,lon
-    int comma = locData.indexOf(',');
-    if (comma > 0)
+    // Receiver on first (deferred by setMode() if the queue is busy),
+    // then the location and GPS status while there is room
+    requestFix();
+    if (!locationPending && at_free() > 0 && command("AT+LOCATION=2", 2000, onLocationReply))
+    {
+        locationPending = true;
+    }
+    if (at_free() > 0)
     {
-        gpsData.latitude = locData.substring(0, comma).toFloat();
+        command("AT+GPS?", 1000, onPrintReply);
+    }
+}
+
+void A9G_GPS::update()
+{
+    // Replies, URCs and NMEA are all handled from here; the fix itself
+    // comes from the +GPSRD sentences parsed in onNmea()
+    at_poll();
 
-        // Get longitude (may have more data after it)
-        int comma2 = locData.indexOf(',', comma + 1);
-        if (comma2 > 0)
+    if (isBooting() && bootState != A9G_BOOT_OFF)
+    {
+        bootStep();
+    }
+    else if (bootState == A9G_BOOT_READY)
+    {
+        if (modePending)
         {
-            gpsData.longitude = locData.substring(comma + 1, comma2).toFloat();
+            setMode(pendingMode, pendingReason);
         }
-        else
+        if (millis() - policyMs >= GPS_POLICY_MS)
         {
-            gpsData.longitude = locData.substring(comma + 1).toFloat();
+            powerPolicy();
         }
-
-        // Mark as valid if coordinates are non-zero
-        if (gpsData.latitude != 0.0 && gpsData.longitude != 0.0)
+#if GPS_LBS
+        // Cell tower position while the receiver has no fix
+        if (!gpsData.valid && !cellPending && (int32_t)(millis() - cellNextMs) >= 0)
         {
-            gpsData.valid = true;
-            SerialUSB.print(F("GPS: "));
-            SerialUSB.print(gpsData.latitude, 6);
-            SerialUSB.print(F(", "));
-            SerialUSB.println(gpsData.longitude, 6);
+            cellPending = command("AT+LOCATION=1", GPS_LBS_TIMEOUT_MS, onCellReply);
+            cellNextMs = millis() + GPS_LBS_RETRY_MS;
         }
-        else
+#endif
+    }
+}
+
+// ===================================
+// AT Replies and Unsolicited Lines
+// ===================================
+
+bool A9G_GPS::command(const char *cmd, uint32_t timeoutMs, AtDoneFn done, const char *urc)
+{
+    if (!at_submitUntil(cmd, urc, timeoutMs, done, this))
+    {
+        SerialUSB.print(F("A9G: AT queue full, dropped "));
+        SerialUSB.println(cmd);
+        return false;
+    }
+    return true;
+}
+
+void A9G_GPS::noteResponse(const char *response)
+{
+    strncpy(debugInfo.lastCommand, at_lastCommand(), sizeof(debugInfo.lastCommand) - 1);
+    debugInfo.lastCommand[sizeof(debugInfo.lastCommand) - 1] = '\0';
+    strncpy(debugInfo.lastResponse, response, sizeof(debugInfo.lastResponse) - 1);
+    debugInfo.lastResponse[sizeof(debugInfo.lastResponse) - 1] = '\0';
+    seq[GPS_SEQ_DEBUG]++;
+}
+
+void A9G_GPS::setStatus(const char *status)
+{
+    strncpy(debugInfo.gpsStatus, status, sizeof(debugInfo.gpsStatus) - 1);
+    debugInfo.gpsStatus[sizeof(debugInfo.gpsStatus) - 1] = '\0';
+    seq[GPS_SEQ_DEBUG]++;
+}
+
+void A9G_GPS::onPrintReply(void *ctx, AtResult result, const char *response)
+{
+    A9G_GPS *gps = (A9G_GPS *)ctx;
+    gps->noteResponse(response);
+
+    SerialUSB.print(at_lastCommand());
+    SerialUSB.print(result == AT_OK ? F(" -> ") : (result == AT_ERROR ? F(" -> ERROR ") : F(" -> TIMEOUT ")));
+    SerialUSB.println(response);
+}
+
+// Response format: "lat,lon\n\nOK" or "+LOCATION: lat,lon,date,time"
+// Parsed in place around the first comma, so the command echo and
+// "+LOCATION:" prefix need no copies. Zero coordinates mean no position.
+static bool a9g_parseLatLon(const char *response, int32_t *lat, int32_t *lon)
+{
+    const char *comma = strchr(response, ',');
+    if (comma == NULL)
+    {
+        return false;
+    }
+
+    // Latitude is the number directly before the comma
+    const char *latStart = comma;
+    while (latStart > response &&
+           (isdigit((unsigned char)latStart[-1]) || latStart[-1] == '.' || latStart[-1] == '-'))
+    {
+        latStart--;
+    }
+
+    // Parse: lat,lon (longitude may have more data after it)
+    const char *end;
+    *lat = geo_parseE7(latStart, &end);
+    if (end != comma)
+    {
+        return false;
+    }
+    *lon = geo_parseE7(comma + 1, &end);
+    return end != comma + 1 && *lat != 0 && *lon != 0;
+}
+
+void A9G_GPS::onLocationReply(void *ctx, AtResult result, const char *response)
+{
+    A9G_GPS *gps = (A9G_GPS *)ctx;
+    gps->locationPending = false;
+    gps->noteResponse(response);
+    gps->debugInfo.fixAttempts++;
+    strncpy(gps->debugInfo.locationResponse, response, sizeof(gps->debugInfo.locationResponse) - 1);
+    gps->debugInfo.locationResponse[sizeof(gps->debugInfo.locationResponse) - 1] = '\0';
+
+    // Simple parsing: just look for lat,lon pattern
+    const char *comma = strchr(response, ',');
+    if (result == AT_OK && comma != NULL && comma != response)
+    {
+        // Got valid response with coordinates
+        gps->parseGPSLocation(response);
+        if (gps->gpsData.valid)
         {
-            gpsData.valid = false;
+            gps->debugInfo.lastUpdateTime = millis();
         }
+        gps->logGPSData(); // Log to SD card
     }
+    // No fix or error: validity stays with the NMEA stream
+    gps->seq[GPS_SEQ_FIX]++;
 }
 
-String A9G_GPS::sendCommand(String cmd, unsigned long timeout)
+// Cell tower position, kept only while the receiver has no fix
+void A9G_GPS::onCellReply(void *ctx, AtResult result, const char *response)
 {
-    String response = "";
-    Serial1.println(cmd);
+    A9G_GPS *gps = (A9G_GPS *)ctx;
+    gps->noteResponse(response);
+    gps->cellPending = false;
+
+    int32_t lat, lon;
+    if (result != AT_OK || !a9g_parseLatLon(response, &lat, &lon) || gps->gpsData.valid)
+    {
+        return; // Asked again at cellNextMs while there is still no fix
+    }
+    gps->cellFix.source = GPS_LOC_CELL;
+    gps->cellFix.latE7 = lat;
+    gps->cellFix.lonE7 = lon;
+    gps->cellFix.accuracyM = GPS_LBS_ACCURACY_M;
+    gps->cellFix.atMs = millis();
+    gps->cellNextMs = millis() + GPS_LBS_REFRESH_MS;
+    gps->seq[GPS_SEQ_FIX]++;
+
+    char latText[16], lonText[16];
+    geo_formatE7(latText, sizeof(latText), lat, 6);
+    geo_formatE7(lonText, sizeof(lonText), lon, 6);
+    SerialUSB.print(F("GPS: cell position "));
+    SerialUSB.print(latText);
+    SerialUSB.print(F(", "));
+    SerialUSB.println(lonText);
+}
+
+void A9G_GPS::onNmea(void *ctx, const char *line)
+{
+    A9G_GPS *gps = (A9G_GPS *)ctx;
+    if (strncmp(line, "$GP", 3) == 0 || strncmp(line, "$GN", 3) == 0)
+    {
+        gps->addNMEASentence(line);
+    }
+
+    // The AT engine strips the line ending; put one back to end the sentence
+    for (const char *c = line; *c != '\0'; c++)
+    {
+        nmea_feed(&gps->nmea, *c, &gps->gpsData);
+    }
+    NmeaType type = nmea_feed(&gps->nmea, '\n', &gps->gpsData);
+    if (type != NMEA_NONE)
+    {
+        gps->seq[GPS_SEQ_FIX]++;
+    }
 
-    unsigned long start = millis();
-    while (millis() - start < timeout)
+    // Position sentences carry the fix; the simplifier decides which to keep
+    if (type == NMEA_GGA || type == NMEA_RMC)
     {
-        while (Serial1.available())
+        if (gps->gpsData.valid)
         {
-            char c = Serial1.read();
-            response += c;
+            gps->debugInfo.lastUpdateTime = millis();
+            gps->noteFix();
         }
+        gps->logGPSData();
     }
+}
 
-    return response;
+void A9G_GPS::onUrc(void *ctx, const char *line)
+{
+    (void)ctx;
+    SerialUSB.print(F("A9G URC: "));
+    SerialUSB.println(line);
 }
 
-GPSData A9G_GPS::getGPSData()
+void A9G_GPS::parseGPSLocation(const char *response)
 {
-    return gpsData;
+    int32_t lat, lon;
+    if (a9g_parseLatLon(response, &lat, &lon))
+    {
+        gpsData.latE7 = lat;
+        gpsData.lonE7 = lon;
+        gpsData.valid = true;
+        char latText[16], lonText[16];
+        geo_formatE7(latText, sizeof(latText), lat, 6);
+        geo_formatE7(lonText, sizeof(lonText), lon, 6);
+        SerialUSB.print(F("GPS: "));
+        SerialUSB.print(latText);
+        SerialUSB.print(F(", "));
+        SerialUSB.println(lonText);
+    }
+    else
+    {
+        gpsData.valid = false;
+    }
 }
 
-GPSDebugInfo A9G_GPS::getDebugInfo()
+const GPSData *A9G_GPS::getGPSData()
 {
-    return debugInfo;
+    return &gpsData;
 }
 
-NMEABuffer A9G_GPS::getNMEABuffer()
+const NmeaParser *A9G_GPS::getNmeaStats()
 {
-    return nmeaBuffer;
+    return &nmea;
+}
+
+const GPSDebugInfo *A9G_GPS::getDebugInfo()
+{
+    return &debugInfo;
+}
+
+uint32_t A9G_GPS::getSeq(GPSSeqGroup group)
+{
+    return seq[group];
+}
+
+void A9G_GPS::attachNMEAHistory(NMEABuffer *buffer)
+{
+    if (buffer != NULL)
+    {
+        buffer->writeIndex = 0;
+        buffer->count = 0;
+    }
+    nmeaHistory = buffer;
+}
+
+void A9G_GPS::detachNMEAHistory()
+{
+    nmeaHistory = NULL;
+}
+
+const NMEABuffer *A9G_GPS::getNMEAHistory()
+{
+    return nmeaHistory;
 }
 
 void A9G_GPS::addNMEASentence(const char *sentence)
 {
+    if (nmeaHistory == NULL)
+    {
+        return;
+    }
+
     // Copy sentence to buffer (strip trailing whitespace)
     int len = strlen(sentence);
     if (len > 81)
@@ -292,15 +932,16 @@ void A9G_GPS::addNMEASentence(const char *sentence)
         len--;
     }
 
-    strncpy(nmeaBuffer.sentences[nmeaBuffer.writeIndex], sentence, len);
-    nmeaBuffer.sentences[nmeaBuffer.writeIndex][len] = '\0';
+    strncpy(nmeaHistory->sentences[nmeaHistory->writeIndex], sentence, len);
+    nmeaHistory->sentences[nmeaHistory->writeIndex][len] = '\0';
 
     // Update circular buffer indices
-    nmeaBuffer.writeIndex = (nmeaBuffer.writeIndex + 1) % NMEA_BUFFER_SIZE;
-    if (nmeaBuffer.count < NMEA_BUFFER_SIZE)
+    nmeaHistory->writeIndex = (nmeaHistory->writeIndex + 1) % NMEA_BUFFER_SIZE;
+    if (nmeaHistory->count < NMEA_BUFFER_SIZE)
     {
-        nmeaBuffer.count++;
+        nmeaHistory->count++;
     }
+    seq[GPS_SEQ_NMEA]++;
 }
 
 bool A9G_GPS::isGPSValid()
@@ -308,141 +949,278 @@ bool A9G_GPS::isGPSValid()
     return gpsData.valid;
 }
 
-String A9G_GPS::getLocationString()
+bool A9G_GPS::getLocation(GPSLocation *out)
 {
     if (gpsData.valid)
     {
-        char buffer[32];
-        snprintf(buffer, sizeof(buffer), "%.4f,%.4f", gpsData.latitude, gpsData.longitude);
-        return String(buffer);
+        // HDOP is 0 until a GGA has been parsed
+        float accuracy = gpsData.hdop * GPS_UERE_M;
+        accuracy = (accuracy < GPS_UERE_M) ? GPS_UERE_M : (accuracy > 9999.0f) ? 9999.0f : accuracy;
+        out->source = GPS_LOC_GNSS;
+        out->latE7 = gpsData.latE7;
+        out->lonE7 = gpsData.lonE7;
+        out->accuracyM = (uint16_t)accuracy;
+        out->atMs = debugInfo.lastUpdateTime;
+        return true;
+    }
+    *out = cellFix;
+    return cellFix.source != GPS_LOC_NONE;
+}
+
+// "lat,lon", with the accuracy when it is only a cell position
+void A9G_GPS::getLocationString(char *out, size_t outLen)
+{
+    GPSLocation loc;
+    if (getLocation(&loc))
+    {
+        char lonText[16];
+        int n = geo_formatE7(out, outLen, loc.latE7, 4);
+        geo_formatE7(lonText, sizeof(lonText), loc.lonE7, 4);
+        if (n >= 0 && (size_t)n < outLen)
+        {
+            if (loc.source == GPS_LOC_CELL)
+            {
+                snprintf(out + n, outLen - n, ",%s ~%um", lonText, loc.accuracyM);
+            }
+            else
+            {
+                snprintf(out + n, outLen - n, ",%s", lonText);
+            }
+        }
     }
     else
     {
-        return "No GPS Fix";
+        snprintf(out, outLen, "No GPS Fix");
     }
 }
 
 void A9G_GPS::logGPSData()
 {
-    if (!gpsData.valid)
-        return;
-
-    // Open GPS log file
-    File logFile = SD.open("gps_log.txt", FILE_WRITE);
-    if (logFile)
+    // Track points are keyed by UTC, which RMC supplies with the date
+    uint32_t time = nmea_seconds(&gpsData);
+    TrackPoint keep;
+    bool kept;
+    if (gpsData.valid && time != 0)
     {
-        // Write timestamp and coordinates
-        logFile.print(millis() / 1000);
-        logFile.print(",");
-        logFile.print(gpsData.latitude, 6);
-        logFile.print(",");
-        logFile.println(gpsData.longitude, 6);
-        logFile.close();
-
-        SerialUSB.println(F("GPS logged to SD"));
+        TrackPoint fix;
+        fix.time = time;
+        fix.latE7 = gpsData.latE7;
+        fix.lonE7 = gpsData.lonE7;
+        float alt = gpsData.altitude;
+        fix.altM = (int16_t)((alt < -32768.0f) ? -32768.0f : (alt > 32767.0f) ? 32767.0f : alt);
+        kept = track_simplifyPush(&trackFilter, &fix, &keep);
+    }
+    else
+    {
+        // Fix lost: the track so far ends at the last fix
+        kept = track_simplifyFlush(&trackFilter, &keep);
+    }
+    if (kept)
+    {
+        queueTrackPoint(&keep);
     }
 }
 
-String A9G_GPS::fetchLocationName()
+// Receiver going off: store the point the simplifier is holding back and
+// get the track onto the card, since no fix will come to flush it
+void A9G_GPS::endTrack()
 {
-    if (!gpsData.valid)
+    TrackPoint keep;
+    if (track_simplifyFlush(&trackFilter, &keep))
     {
-        return "No GPS Fix";
+        queueTrackPoint(&keep);
     }
+    logSyncDue = true;
+    work_submit("gps-log", flushLogWork, this);
+}
 
-    SerialUSB.println(F("\n=== Fetching Location Name ==="));
+// The SD write happens in idle time, not in the GPS task
+void A9G_GPS::queueTrackPoint(const TrackPoint *p)
+{
+    if (logCount >= GPS_LOG_PENDING)
+    {
+        memmove(&logPending[0], &logPending[1], (GPS_LOG_PENDING - 1) * sizeof(TrackPoint));
+        logCount--;
+        SerialUSB.println(F("GPS log backlog full, oldest fix dropped"));
+    }
+    logPending[logCount++] = *p;
 
-    // Format the URL with coordinates
-    char url[200];
-    snprintf(url, sizeof(url),
-             "aryan241.pythonanywhere.com/get-location?lat=%.6f&lon=%.6f",
-             gpsData.latitude, gpsData.longitude);
+    work_submit("gps-log", flushLogWork, this);
+}
 
-    SerialUSB.print(F("URL: "));
-    SerialUSB.println(url);
+WorkStatus A9G_GPS::flushLogWork(void *ctx, uint32_t deadlineUs)
+{
+    A9G_GPS *gps = (A9G_GPS *)ctx;
 
-    // Setup HTTP connection
-    String response = "";
+    // At least one point per slice so the backlog always drains; most
+    // appends only fill the RAM block, a full one costs a sector write
+    uint8_t written = 0;
+    while (written < gps->logCount && (written == 0 || (int32_t)(deadlineUs - micros()) > 0))
+    {
+        track_append(&gps->logPending[written++]);
+    }
 
-    // Close any existing connections
-    sendCommand("AT+HTTPTERM", 2000);
-    delay(500);
+    gps->logCount -= written;
+    memmove(&gps->logPending[0], &gps->logPending[written], gps->logCount * sizeof(TrackPoint));
+    if (gps->logCount > 0)
+    {
+        return WORK_MORE;
+    }
+    if (gps->logSyncDue)
+    {
+        gps->logSyncDue = false;
+        track_sync();
+    }
+    return WORK_DONE;
+}
 
-    // Initialize HTTP service
-    String result = sendCommand("AT+HTTPINIT", 3000);
-    if (result.indexOf("OK") == -1)
+bool A9G_GPS::fetchLocationName()
+{
+    // A cell position is close enough for a place name
+    GPSLocation loc;
+    if (!getLocation(&loc))
     {
-        SerialUSB.println(F("HTTP init failed"));
-        return "HTTP Init Error";
+        strcpy(locationName, "No GPS Fix");
+        return false;
     }
-    delay(500);
+    if (httpStep != A9G_HTTP_IDLE)
+    {
+        return false;
+    }
+    fetchAt = loc;
 
-    // Set HTTP parameters
-    sendCommand("AT+HTTPPARA=\"CID\",1", 2000);
+    SerialUSB.println(F("\n=== Fetching Location Name ==="));
+    strcpy(locationName, "Unknown");
+    httpStep = 0;
+    submitHttpStep();
+    return true;
+}
 
-    // Set URL
-    String urlCmd = "AT+HTTPPARA=\"URL\",\"" + String(url) + "\"";
-    sendCommand(urlCmd, 2000);
+bool A9G_GPS::isFetchingLocation()
+{
+    return httpStep != A9G_HTTP_IDLE;
+}
 
-    // Set content type
-    sendCommand("AT+HTTPPARA=\"CONTENT\",\"application/json\"", 2000);
+const char *A9G_GPS::getLocationName()
+{
+    return locationName;
+}
 
-    // Perform HTTP GET request
-    SerialUSB.println(F("Performing HTTP GET..."));
-    result = sendCommand("AT+HTTPACTION=0", 15000); // 0 = GET, wait up to 15 seconds
+void A9G_GPS::submitHttpStep()
+{
+    const A9GCommand *step = &httpCommands[httpStep];
+    const char *cmd = step->cmd;
 
-    // Wait for response
-    delay(2000);
+    // Format the URL command with coordinates
+    char urlCmd[AT_CMD_LEN];
+    if (cmd == NULL)
+    {
+        char lat[16], lon[16];
+        geo_formatE7(lat, sizeof(lat), fetchAt.latE7, 6);
+        geo_formatE7(lon, sizeof(lon), fetchAt.lonE7, 6);
+        snprintf(urlCmd, sizeof(urlCmd),
+                 "AT+HTTPPARA=\"URL\",\"aryan241.pythonanywhere.com/get-location?lat=%s&lon=%s\"",
+                 lat, lon);
+        SerialUSB.print(F("URL: "));
+        SerialUSB.println(urlCmd);
+        cmd = urlCmd;
+    }
+    if (httpStep == HTTP_STEP_ACTION)
+    {
+        SerialUSB.println(F("Performing HTTP GET..."));
+    }
+
+    if (!command(cmd, step->timeoutMs, onHttpReply, step->urc))
+    {
+        httpStep = A9G_HTTP_IDLE;
+    }
+}
 
-    // Check HTTP status
-    String statusCmd = sendCommand("AT+HTTPHEAD", 3000);
-    SerialUSB.print(F("HTTP Header: "));
-    SerialUSB.println(statusCmd);
+// Each reply queues the next step, so the request never holds the loop
+void A9G_GPS::onHttpReply(void *ctx, AtResult result, const char *response)
+{
+    A9G_GPS *gps = (A9G_GPS *)ctx;
+    gps->noteResponse(response);
 
-    // Read HTTP response data
-    result = sendCommand("AT+HTTPREAD", 5000);
-    SerialUSB.print(F("HTTP Response: "));
-    SerialUSB.println(result);
+    switch (gps->httpStep)
+    {
+    case HTTP_STEP_INIT:
+        if (result != AT_OK)
+        {
+            SerialUSB.println(F("HTTP init failed"));
+            strcpy(gps->locationName, "HTTP Init Error");
+            gps->httpStep = A9G_HTTP_IDLE;
+            return;
+        }
+        break;
 
-    // Parse JSON response to extract location
-    String locationName = "Unknown";
+    case HTTP_STEP_HEAD:
+        // Check HTTP status
+        SerialUSB.print(F("HTTP Header: "));
+        SerialUSB.println(response);
+        break;
 
-    // Look for "location": "City, State" pattern
-    int locIndex = result.indexOf("\"location\"");
-    if (locIndex != -1)
+    case HTTP_STEP_READ:
     {
-        int startQuote = result.indexOf("\"", locIndex + 12); // Skip past "location":
-        if (startQuote != -1)
+        SerialUSB.print(F("HTTP Response: "));
+        SerialUSB.println(response);
+
+        // Look for "location": "City, State" pattern
+        const char *key = strstr(response, "\"location\"");
+        if (key != NULL)
         {
-            int endQuote = result.indexOf("\"", startQuote + 1);
-            if (endQuote != -1)
+            const char *startQuote = strchr(key + 10, '"'); // Skip past "location"
+            if (startQuote != NULL)
             {
-                locationName = result.substring(startQuote + 1, endQuote);
-                SerialUSB.print(F("Extracted location: "));
-                SerialUSB.println(locationName);
-
-                // Save to cache for future use
-                saveLocationCache(locationName);
+                const char *endQuote = strchr(startQuote + 1, '"');
+                if (endQuote != NULL)
+                {
+                    int len = (int)(endQuote - startQuote - 1);
+                    snprintf(gps->locationName, sizeof(gps->locationName), "%.*s", len, startQuote + 1);
+                    SerialUSB.print(F("Extracted location: "));
+                    SerialUSB.println(gps->locationName);
+
+                    // Save to cache for future use
+                    gps->saveLocationCache(gps->locationName);
+                }
             }
         }
+        break;
     }
 
-    // Terminate HTTP service
-    sendCommand("AT+HTTPTERM", 2000);
+    default:
+        break;
+    }
 
+    if (++gps->httpStep < HTTP_COMMAND_COUNT)
+    {
+        gps->submitHttpStep();
+        return;
+    }
+
+    gps->httpStep = A9G_HTTP_IDLE;
     SerialUSB.println(F("=== Location Fetch Complete ===\n"));
+}
 
-    return locationName;
+// Called from an AT reply; the card is written from the work queue
+void A9G_GPS::saveLocationCache(const char *locationName)
+{
+    strncpy(cacheName, locationName, sizeof(cacheName) - 1);
+    cacheName[sizeof(cacheName) - 1] = '\0';
+    work_submit("gps-loc", locationCacheWork, this);
 }
 
-void A9G_GPS::saveLocationCache(String locationName)
+WorkStatus A9G_GPS::locationCacheWork(void *ctx, uint32_t deadlineUs)
 {
+    (void)deadlineUs; // One short write
+    A9G_GPS *gps = (A9G_GPS *)ctx;
+
     // Save location name to SD card cache file
     File cacheFile = SD.open("loc_cache.txt", FILE_WRITE);
     if (cacheFile)
     {
         cacheFile.seek(0); // Overwrite from beginning
-        cacheFile.println(locationName);
+        cacheFile.println(gps->cacheName);
         cacheFile.close();
         SerialUSB.println(F("Location cached to SD"));
     }
@@ -450,38 +1228,47 @@ void A9G_GPS::saveLocationCache(String locationName)
     {
         SerialUSB.println(F("Failed to save location cache"));
     }
+    return WORK_DONE;
 }
 
-String A9G_GPS::loadLocationCache()
+bool A9G_GPS::loadLocationCache(char *out, size_t outLen)
 {
-    String cachedLocation = "";
+    out[0] = '\0';
 
     if (!SD.exists("loc_cache.txt"))
     {
         SerialUSB.println(F("No location cache found - Press GET LOC to fetch location"));
-        return "";
+        return false;
     }
 
     File cacheFile = SD.open("loc_cache.txt", FILE_READ);
-    if (cacheFile)
+    if (!cacheFile)
     {
-        if (cacheFile.available())
-        {
-            cachedLocation = cacheFile.readStringUntil('\n');
-            cachedLocation.trim(); // Remove any trailing whitespace/newline
-            SerialUSB.print(F("Loaded cached location: "));
-            SerialUSB.println(cachedLocation);
-        }
-        else
+        SerialUSB.println(F("Failed to read location cache"));
+        return false;
+    }
+
+    // Read the first line, dropping the line ending
+    size_t len = 0;
+    while (cacheFile.available() && len < outLen - 1)
+    {
+        char c = cacheFile.read();
+        if (c == '\r' || c == '\n')
         {
-            SerialUSB.println(F("Cache file is empty"));
+            break;
         }
-        cacheFile.close();
+        out[len++] = c;
     }
-    else
+    out[len] = '\0';
+    cacheFile.close();
+
+    if (len == 0)
     {
-        SerialUSB.println(F("Failed to read location cache"));
+        SerialUSB.println(F("Cache file is empty"));
+        return false;
     }
 
-    return cachedLocation;
-}
\ No newline at end of file
+    SerialUSB.print(F("Loaded cached location: "));
+    SerialUSB.println(out);
+    return true;
+}
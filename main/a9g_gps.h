@@ -7,24 +7,98 @@
 #define A9G_GPS_H
 
 #include <Arduino.h>
+#include "workqueue.h"
+#include "at_engine.h"
+#include "uart_rx.h"
+#include "nmea.h"
+#include "track_log.h"
+#include "track_simplify.h"
 
 // A9G Module Control Pins
 #define A9G_PWR_KEY 9
 #define A9G_RST_KEY 6
 #define A9G_LOW_PWR_KEY 5
 
-// GPS Data Structure
+// Power-up timing, stepped by update() instead of blocking in begin()
+#define A9G_PWR_PULSE_MS 3000  // PWR_KEY held low
+#define A9G_PWR_SETTLE_MS 5000 // Boot time after the pulse
+#define A9G_PROBE_TIMEOUT_MS 1000
+#define A9G_PROBE_GAP_MS 500
+#define A9G_PROBE_TRIES 5      // "AT" probes per power pulse
+#define A9G_POWER_TRIES 2      // Power pulses before giving up
+
+#define A9G_HTTP_IDLE 0xFF
+
+// Power-up stages, in order
+typedef enum
+{
+    A9G_BOOT_OFF = 0,   // begin() not called yet
+    A9G_BOOT_PWR_PULSE,
+    A9G_BOOT_PWR_SETTLE,
+    A9G_BOOT_PROBE,     // Waiting for the reply to "AT"
+    A9G_BOOT_PROBE_GAP,
+    A9G_BOOT_GPS_INIT,  // GPS enable commands queued
+    A9G_BOOT_READY,
+    A9G_BOOT_FAILED
+} A9GBootState;
+
+// GPS receiver duty cycle, chosen by the power policy in update()
+typedef enum
+{
+    GPS_MODE_TRACK = 0, // Receiver on, NMEA every second
+    GPS_MODE_SLOW,      // Receiver on, NMEA every GPS_SLOW_RD_S
+    GPS_MODE_OFF        // AT+GPS=0, the last fix stays cached
+} GPSPowerMode;
+
+// What the receiver had to start from when it was powered on
+typedef enum
+{
+    GPS_START_COLD = 0, // No usable ephemeris: almanac search, 30-60 s
+    GPS_START_WARM,     // Fix within GPS_WARM_MAX_MS, ephemeris still valid
+    GPS_START_ASSISTED, // Ephemeris downloaded over GPRS (AT+AGPS=1)
+    GPS_START_KINDS
+} GPSStartKind;
+
+// Time to first fix after a power-on, per start kind
+typedef struct
+{
+    uint32_t lastMs;
+    uint32_t minMs;
+    uint32_t maxMs;
+    uint16_t count;
+} GPSTtff;
+
+typedef struct
+{
+    GPSPowerMode mode;
+    const char *reason;        // Why the mode was entered
+    unsigned long modeSinceMs;
+    bool acquiring;            // Receiver on, no fix since it was turned on
+    unsigned long acquireMs;   // When the receiver was turned on
+    GPSStartKind start;        // Of the current or last power-on
+    GPSTtff ttff[GPS_START_KINDS];
+    uint16_t ttffFails;        // Power-ons given up without a fix
+    uint16_t agpsFails;        // AT+AGPS=1 errors and timeouts
+    uint32_t onMs;             // Receiver on time since the module booted
+    uint32_t upMs;
+} GPSPowerInfo;
+
+// Best position available, from the receiver or the cell towers
+typedef enum
+{
+    GPS_LOC_NONE = 0,
+    GPS_LOC_CELL,   // AT+LOCATION=1, until the receiver has a fix
+    GPS_LOC_GNSS
+} GPSLocSource;
+
 typedef struct
 {
-    bool valid;
-    float latitude;
-    float longitude;
-    float altitude;
-    uint8_t satellites;
-    char latDirection;   // 'N' or 'S'
-    char lonDirection;   // 'E' or 'W'
-    char lastUpdate[20]; // Time string
-} GPSData;
+    GPSLocSource source;
+    int32_t latE7;
+    int32_t lonE7;
+    uint16_t accuracyM;    // Estimated error radius
+    unsigned long atMs;    // millis() of the position
+} GPSLocation;
 
 // GPS Debug Info Structure
 typedef struct
@@ -37,6 +111,18 @@ typedef struct
     int fixAttempts;
 } GPSDebugInfo;
 
+// Field groups of the GPS state. Each has a counter that goes up whenever
+// anything in the group changes, so a reader can keep the last value it
+// saw and skip work while the group is unchanged.
+typedef enum
+{
+    GPS_SEQ_FIX = 0, // GPSData
+    GPS_SEQ_DEBUG,   // GPSDebugInfo
+    GPS_SEQ_NMEA,    // Lent NMEA history
+    GPS_SEQ_POWER,   // GPSPowerInfo mode and TTFF
+    GPS_SEQ_GROUPS
+} GPSSeqGroup;
+
 // NMEA Circular Buffer
 #define NMEA_BUFFER_SIZE 10
 #define NMEA_MAX_LEN 83
@@ -48,38 +134,127 @@ typedef struct
     uint8_t count;
 } NMEABuffer;
 
+// Fixes waiting for the work queue to append them to the track log
+#define GPS_LOG_PENDING 8
+
 class A9G_GPS
 {
 private:
     bool moduleOn;
     GPSData gpsData;
+    NmeaParser nmea;           // Fed from onNmea(), fills gpsData
     GPSDebugInfo debugInfo;
-    NMEABuffer nmeaBuffer;
-    unsigned long lastGPSRead;
-    unsigned long gpsReadInterval;
-
-    String sendCommand(String cmd, unsigned long timeout);
-    bool checkModuleState();
-    void parseGPSLocation(String response);
-    void parseNMEA(String nmea);
+    NMEABuffer *nmeaHistory; // Lent by the GPS debug page, NULL while hidden
+    bool locationPending;      // AT+LOCATION=2 in flight
+    GPSLocation cellFix;       // GPS_LOC_NONE once a GNSS fix supersedes it
+    bool cellPending;          // AT+LOCATION=1 in flight
+    unsigned long cellNextMs;  // Next cell location request
+    GPSLocation fetchAt;       // Position of the place name lookup
+    uint8_t httpStep;          // Location name request step, A9G_HTTP_IDLE if none
+    char locationName[48];
+    char cacheName[48];        // Place name waiting for locationCacheWork()
+    TrackSimplifier trackFilter; // Every fix goes in, track points come out
+    TrackPoint logPending[GPS_LOG_PENDING];
+    uint8_t logCount;
+    bool logSyncDue;           // Sync the track log once logPending drains
+    uint32_t seq[GPS_SEQ_GROUPS];
+    A9GBootState bootState;
+    unsigned long bootMs;      // Start of the current boot stage
+    uint8_t bootTries;         // Power pulses so far
+    uint8_t bootProbes;        // "AT" probes since the last pulse
+    uint8_t bootCmd;           // GPS init commands answered so far
+    GPSPowerInfo power;
+    unsigned long policyMs;    // Last power policy run
+    unsigned long holdUntilMs; // Requested by the user, stay in TRACK until then
+    bool modePending;          // setMode() waiting for room in the AT queue
+    GPSPowerMode pendingMode;
+    const char *pendingReason;
+    int32_t stillLatE7;        // Where the device has been since stillSinceMs
+    int32_t stillLonE7;
+    unsigned long stillSinceMs;
+    bool stillValid;
+    bool wakeCheck;            // Woken from OFF only to see if it has moved
+    bool hadFix;               // Since the module was powered
+    unsigned long lastFixMs;
+    bool agpsPending;          // AT+CGATT? or AT+AGPS=1 in flight
+    bool agpsTried;            // AGPS requested for this power-on
+    unsigned long agpsCheckMs; // Last GPRS check while acquiring cold
+    TrackPoint lastFix;        // Last fix with a time, kept in GPS_LAST_FILE
+    bool lastFixValid;
+    bool lastFixLoaded;        // GPS_LAST_FILE read since boot
+    bool lastFixDirty;         // lastFix not written yet
+    bool lastFixDue;           // Save the next fix that has a time
+    unsigned long lastSaveMs;
+
+    // Commands go through the AT engine; replies arrive in these callbacks
+    bool command(const char *cmd, uint32_t timeoutMs, AtDoneFn done, const char *urc = NULL);
+    void noteResponse(const char *response);
+    void setStatus(const char *status);
+    void bootStep();
+    void setMode(GPSPowerMode mode, const char *reason);
+    void powerPolicy();
+    void startAcquire();
+    void noteFix();
+    void saveLastFix();
+    static WorkStatus lastFixWork(void *ctx, uint32_t deadlineUs);
+    void submitHttpStep();
+    static void onProbeReply(void *ctx, AtResult result, const char *response);
+    static void onInitReply(void *ctx, AtResult result, const char *response);
+    static void onBaudReply(void *ctx, AtResult result, const char *response);
+    static void onGprsReply(void *ctx, AtResult result, const char *response);
+    static void onAgpsReply(void *ctx, AtResult result, const char *response);
+    static void onCellReply(void *ctx, AtResult result, const char *response);
+    static void onLocationReply(void *ctx, AtResult result, const char *response);
+    static void onHttpReply(void *ctx, AtResult result, const char *response);
+    static void onPrintReply(void *ctx, AtResult result, const char *response);
+    static void onNmea(void *ctx, const char *line);
+    static void onUrc(void *ctx, const char *line);
+    void parseGPSLocation(const char *response);
     void addNMEASentence(const char *sentence);
     void logGPSData();
-    void saveLocationCache(String locationName);
-    String loadLocationCache();
+    void queueTrackPoint(const TrackPoint *p);
+    void endTrack();
+    static WorkStatus flushLogWork(void *ctx, uint32_t deadlineUs);
+    void saveLocationCache(const char *locationName);
+    static WorkStatus locationCacheWork(void *ctx, uint32_t deadlineUs);
+    bool loadLocationCache(char *out, size_t outLen);
 
 public:
     A9G_GPS();
-    bool begin();
+    // Starts the power-up sequence and returns; update() completes it
+    void begin();
     void update();
-    GPSData getGPSData();
-    GPSDebugInfo getDebugInfo();
-    NMEABuffer getNMEABuffer();
+    bool isBooting();
+    // Short progress text for the header, NULL once ready or failed
+    const char *getBootStage();
+    // Views of the live state: valid until the next update(), check the
+    // group's getSeq() to see whether they changed
+    const GPSData *getGPSData();
+    const NmeaParser *getNmeaStats();
+    const GPSDebugInfo *getDebugInfo();
+    uint32_t getSeq(GPSSeqGroup group);
+    // Recent sentences are only kept while a page has lent a buffer
+    void attachNMEAHistory(NMEABuffer *buffer);
+    void detachNMEAHistory();
+    const NMEABuffer *getNMEAHistory();
     bool isGPSValid();
+    // The GNSS fix, or a cell tower position while there is none
+    bool getLocation(GPSLocation *out);
+    // Power the receiver up to TRACK and keep it there for GPS_USER_HOLD_MS
+    void requestFix();
+    const GPSPowerInfo *getPowerInfo();
+    // Last fix with a time, from this session or GPS_LAST_FILE; NULL if none
+    const TrackPoint *getLastFix();
+    void printPowerStats();
     void turnOnGPS();
     void turnOffGPS();
-    String getLocationString();
+    void getLocationString(char *out, size_t outLen);
     void refreshDebugInfo();
-    String fetchLocationName();
+    // Starts an HTTP lookup of the place name for getLocation(); the
+    // result is read with getLocationName() once isFetchingLocation() ends
+    bool fetchLocationName();
+    bool isFetchingLocation();
+    const char *getLocationName();
 };
 
 #endif // A9G_GPS_H
\ No newline at end of file
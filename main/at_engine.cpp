@@ -0,0 +1,366 @@
+/**
+ * @file at_engine.cpp
+ * @brief Non-Blocking AT Command Engine Implementation
+ */
+
+#include "at_engine.h"
+#include "uart_rx.h"
+
+// ===================================
+// Command Queue
+// ===================================
+
+typedef struct
+{
+    char cmd[AT_CMD_LEN];
+    const char *urcPrefix; // Completes on this URC after "OK" (NULL = on "OK")
+    uint32_t timeoutMs;
+    AtDoneFn done;
+    void *ctx;
+} AtCommand;
+
+static AtCommand atQueue[AT_QUEUE_SIZE];
+static uint8_t atHead = 0;
+static uint8_t atCount = 0;
+static bool atInFlight = false; // atQueue[atHead] has been sent
+static bool atGotOk = false;    // In flight and waiting for its URC
+static bool atEchoSeen = false; // Lines before the echo are not its reply
+static uint32_t atSentMs = 0;
+static char atLastCmd[AT_CMD_LEN];
+
+// Line being assembled and the response of the command in flight
+static char atLine[AT_LINE_LEN];
+static uint16_t atLineLen = 0;
+static bool atLineCut = false;
+static bool atLineLost = false; // Ring overflowed while this line came in
+static uint32_t atOverflows = 0;
+static char atResponse[AT_RESPONSE_LEN];
+static uint16_t atResponseLen = 0;
+static bool atResponseCut = false;
+
+static AtLineFn atNmeaFn = NULL;
+static AtLineFn atUrcFn = NULL;
+static void *atHandlerCtx = NULL;
+
+static AtStats atStats;
+
+// Plain-text URCs; any other line without '+' during a command is data
+static const char *const plainUrcs[] = {"READY", "RING", "NO CARRIER", "NORMAL POWER DOWN"};
+
+static bool startsWith(const char *s, const char *prefix)
+{
+    return strncmp(s, prefix, strlen(prefix)) == 0;
+}
+
+// ===================================
+// Line Routing
+// ===================================
+
+// "+GPS: 1" answers "AT+GPS?": the names before ':' and '='/'?' match
+static bool at_isResponse(const char *line, const char *cmd)
+{
+    if (line[0] != '+')
+    {
+        for (uint8_t i = 0; i < sizeof(plainUrcs) / sizeof(plainUrcs[0]); i++)
+        {
+            if (strcmp(line, plainUrcs[i]) == 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const char *name = cmd + 2; // Skip "AT"
+    size_t len = 0;
+    while (name[len] != '\0' && name[len] != '=' && name[len] != '?')
+    {
+        len++;
+    }
+    return strncmp(line, name, len) == 0 && (line[len] == ':' || line[len] == '\0');
+}
+
+static void at_appendResponse(const char *line)
+{
+    size_t len = strlen(line);
+    if (atResponseLen + len + 1 >= sizeof(atResponse))
+    {
+        if (!atResponseCut)
+        {
+            atResponseCut = true;
+            atStats.truncated++;
+        }
+        return;
+    }
+    memcpy(&atResponse[atResponseLen], line, len);
+    atResponseLen += len;
+    atResponse[atResponseLen++] = '\n';
+    atResponse[atResponseLen] = '\0';
+}
+
+static void at_complete(AtResult result)
+{
+    AtCommand *c = &atQueue[atHead];
+    AtDoneFn done = c->done;
+    void *ctx = c->ctx;
+
+    uint32_t latency = millis() - atSentMs;
+    if (latency > atStats.maxLatencyMs)
+    {
+        atStats.maxLatencyMs = latency;
+    }
+    if (result == AT_OK)
+    {
+        atStats.ok++;
+    }
+    else if (result == AT_ERROR)
+    {
+        atStats.errors++;
+    }
+    else
+    {
+        atStats.timeouts++;
+    }
+
+    // Free the slot first so the callback can queue a follow-up command
+    atHead = (atHead + 1) % AT_QUEUE_SIZE;
+    atCount--;
+    atInFlight = false;
+    atGotOk = false;
+    atEchoSeen = false;
+
+    if (done != NULL)
+    {
+        done(ctx, result, atResponse);
+    }
+}
+
+static void at_routeLine(char *line)
+{
+    if (line[0] == '\0')
+    {
+        return;
+    }
+
+    // With AT+GPSRD the module prefixes every sentence
+    const char *nmea = line;
+    if (startsWith(nmea, "+GPSRD:"))
+    {
+        nmea += 7;
+        while (*nmea == ' ')
+        {
+            nmea++;
+        }
+    }
+    if (nmea[0] == '$')
+    {
+        atStats.nmea++;
+        if (atNmeaFn != NULL)
+        {
+            atNmeaFn(atHandlerCtx, nmea);
+        }
+        return;
+    }
+
+    if (atInFlight)
+    {
+        const AtCommand *c = &atQueue[atHead];
+        if (strcmp(line, c->cmd) == 0)
+        {
+            atEchoSeen = true;
+            return;
+        }
+        if (!atEchoSeen)
+        {
+            // Late reply to a command that timed out. Its result codes and
+            // data lines are dropped; "+" lines go to the URC handler as
+            // they would with nothing in flight
+            bool result = startsWith(line, "+CME ERROR") || startsWith(line, "+CMS ERROR");
+            if (result || (line[0] != '+' && at_isResponse(line, c->cmd)))
+            {
+                atStats.stale++;
+                return;
+            }
+        }
+        else if (!atGotOk)
+        {
+            if (strcmp(line, "OK") == 0)
+            {
+                if (c->urcPrefix != NULL)
+                {
+                    atGotOk = true;
+                }
+                else
+                {
+                    at_complete(AT_OK);
+                }
+                return;
+            }
+            if (strcmp(line, "ERROR") == 0 || startsWith(line, "+CME ERROR") ||
+                startsWith(line, "+CMS ERROR"))
+            {
+                at_appendResponse(line);
+                at_complete(AT_ERROR);
+                return;
+            }
+            if (at_isResponse(line, c->cmd))
+            {
+                at_appendResponse(line);
+                return;
+            }
+        }
+        else if (startsWith(line, c->urcPrefix))
+        {
+            at_appendResponse(line);
+            at_complete(AT_OK);
+            return;
+        }
+    }
+
+    atStats.urcs++;
+    if (atUrcFn != NULL)
+    {
+        atUrcFn(atHandlerCtx, line);
+    }
+}
+
+static void at_startNext(void)
+{
+    if (atInFlight || atCount == 0)
+    {
+        return;
+    }
+
+    const AtCommand *c = &atQueue[atHead];
+    atResponseLen = 0;
+    atResponse[0] = '\0';
+    atResponseCut = false;
+    strcpy(atLastCmd, c->cmd);
+
+    Serial1.println(c->cmd);
+    atSentMs = millis();
+    atInFlight = true;
+    atStats.sent++;
+}
+
+// ===================================
+// Public API
+// ===================================
+
+void at_setHandlers(AtLineFn nmea, AtLineFn urc, void *ctx)
+{
+    atNmeaFn = nmea;
+    atUrcFn = urc;
+    atHandlerCtx = ctx;
+}
+
+bool at_submitUntil(const char *cmd, const char *urcPrefix, uint32_t timeoutMs,
+                    AtDoneFn done, void *ctx)
+{
+    if (atCount >= AT_QUEUE_SIZE || strlen(cmd) >= AT_CMD_LEN)
+    {
+        atStats.rejected++;
+        return false;
+    }
+
+    AtCommand *c = &atQueue[(atHead + atCount) % AT_QUEUE_SIZE];
+    strcpy(c->cmd, cmd);
+    c->urcPrefix = urcPrefix;
+    c->timeoutMs = timeoutMs;
+    c->done = done;
+    c->ctx = ctx;
+    atCount++;
+    if (atCount > atStats.peakDepth)
+    {
+        atStats.peakDepth = atCount;
+    }
+    return true;
+}
+
+bool at_submit(const char *cmd, uint32_t timeoutMs, AtDoneFn done, void *ctx)
+{
+    return at_submitUntil(cmd, NULL, timeoutMs, done, ctx);
+}
+
+void at_poll(void)
+{
+    int n = uart_available();
+
+    // Bytes were lost: the line being assembled is spliced, drop it
+    if (uart_getStats()->overflows != atOverflows)
+    {
+        atOverflows = uart_getStats()->overflows;
+        atLineLost = true;
+    }
+
+    while (n-- > 0)
+    {
+        char c = (char)uart_read();
+        if (c == '\r')
+        {
+            continue;
+        }
+        if (c == '\n')
+        {
+            atLine[atLineLen] = '\0';
+            if (!atLineLost)
+            {
+                at_routeLine(atLine);
+            }
+            atLineLen = 0;
+            atLineCut = false;
+            atLineLost = false;
+        }
+        else if (atLineLen < sizeof(atLine) - 1)
+        {
+            atLine[atLineLen++] = c;
+        }
+        else if (!atLineCut)
+        {
+            atLineCut = true;
+            atStats.truncated++;
+        }
+    }
+
+    if (atInFlight && millis() - atSentMs >= atQueue[atHead].timeoutMs)
+    {
+        at_complete(AT_TIMEOUT);
+    }
+
+    at_startNext();
+}
+
+bool at_busy(void)
+{
+    return atCount > 0;
+}
+
+uint8_t at_free(void)
+{
+    return AT_QUEUE_SIZE - atCount;
+}
+
+const char *at_lastCommand(void)
+{
+    return atLastCmd;
+}
+
+const AtStats *at_getStats(void)
+{
+    return &atStats;
+}
+
+void at_printStats(void)
+{
+    char line[112];
+    snprintf(line, sizeof(line), "at sent=%lu ok=%lu err=%lu tmo=%lu rej=%lu max=%lums peak=%u",
+             (unsigned long)atStats.sent, (unsigned long)atStats.ok,
+             (unsigned long)atStats.errors, (unsigned long)atStats.timeouts,
+             (unsigned long)atStats.rejected, (unsigned long)atStats.maxLatencyMs,
+             atStats.peakDepth);
+    SerialUSB.println(line);
+    snprintf(line, sizeof(line), "   nmea=%lu urc=%lu cut=%lu stale=%lu",
+             (unsigned long)atStats.nmea, (unsigned long)atStats.urcs,
+             (unsigned long)atStats.truncated, (unsigned long)atStats.stale);
+    SerialUSB.println(line);
+}
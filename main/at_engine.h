@@ -0,0 +1,127 @@
+/**
+ * @file at_engine.h
+ * @brief Non-Blocking AT Command Engine for the A9G Link
+ *
+ * Commands are queued and sent one at a time on Serial1. at_poll() drains
+ * the DMA receive ring (uart_rx.h) into lines and routes each one:
+ *   - NMEA sentences (bare or behind "+GPSRD:") go to the NMEA handler
+ *   - lines belonging to the command in flight go into its response
+ *   - everything else is an unsolicited result code for the URC handler
+ * A command completes as soon as its final result code arrives (or, when
+ * it waits for a URC, when that URC arrives) instead of after a fixed
+ * delay, and the next queued command is sent right away. Lines count for
+ * a command only after its echo (the module runs with ATE1), so a late
+ * reply to one that timed out cannot complete the next.
+ */
+
+#ifndef AT_ENGINE_H
+#define AT_ENGINE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===================================
+// Command Results
+// ===================================
+typedef enum
+{
+    AT_OK = 0,
+    AT_ERROR,   // ERROR, +CME ERROR or +CMS ERROR
+    AT_TIMEOUT
+} AtResult;
+
+// Called once per command; response holds the lines between the echo and
+// the final result code (plus the awaited URC), '\n' separated
+typedef void (*AtDoneFn)(void *ctx, AtResult result, const char *response);
+
+// NMEA sentence or URC line, without line ending or "+GPSRD:" prefix
+typedef void (*AtLineFn)(void *ctx, const char *line);
+
+// ===================================
+// Engine Statistics
+// ===================================
+typedef struct
+{
+    uint32_t sent;
+    uint32_t ok;
+    uint32_t errors;
+    uint32_t timeouts;
+    uint32_t rejected;     // Submits refused by a full queue
+    uint32_t nmea;         // Sentences routed to the NMEA handler
+    uint32_t urcs;         // Unsolicited lines routed to the URC handler
+    uint32_t truncated;    // Lines or responses cut at their buffer size
+    uint32_t stale;        // Result and data lines dropped before an echo
+    uint32_t maxLatencyMs; // Longest send to final result
+    uint8_t peakDepth;
+} AtStats;
+
+// ===================================
+// AT Engine Functions
+// ===================================
+
+/**
+ * @brief Set the handlers for NMEA sentences and unsolicited lines
+ * @param nmea NMEA handler (NULL to drop sentences)
+ * @param urc URC handler (NULL to drop them)
+ * @param ctx Passed to both handlers
+ */
+void at_setHandlers(AtLineFn nmea, AtLineFn urc, void *ctx);
+
+/**
+ * @brief Queue a command
+ * @param cmd Command text without line ending (copied)
+ * @param timeoutMs Time allowed from sending to completion
+ * @param done Completion callback (may be NULL)
+ * @param ctx Passed to done
+ * @return false if the queue is full or the command is too long
+ */
+bool at_submit(const char *cmd, uint32_t timeoutMs, AtDoneFn done, void *ctx);
+
+/**
+ * @brief Queue a command that also waits for a URC after its "OK"
+ *
+ * For commands such as AT+HTTPACTION whose real result arrives later as
+ * an unsolicited line. That line is appended to the response.
+ * @param urcPrefix Line prefix that completes the command (must stay valid)
+ */
+bool at_submitUntil(const char *cmd, const char *urcPrefix, uint32_t timeoutMs,
+                    AtDoneFn done, void *ctx);
+
+/**
+ * @brief Drain the receive ring, route lines, complete and start commands
+ *
+ * Non-blocking; run it at least every UART_RX_RING_SIZE byte times or the
+ * ring overflows (the line then being received is dropped).
+ */
+void at_poll(void);
+
+/**
+ * @brief Check for a command in flight or queued
+ * @return true while busy
+ */
+bool at_busy(void);
+
+/**
+ * @brief Free queue slots, for callers that must queue several commands
+ * @return Commands that at_submit() would accept now
+ */
+uint8_t at_free(void);
+
+/**
+ * @brief Text of the command in flight, or of the last one sent
+ * @return Command text ("" before the first command)
+ */
+const char *at_lastCommand(void);
+
+/**
+ * @brief Get engine statistics
+ * @return Pointer to statistics
+ */
+const AtStats *at_getStats(void);
+
+/**
+ * @brief Print command and routing counters over SerialUSB
+ */
+void at_printStats(void);
+
+#endif // AT_ENGINE_H
@@ -50,6 +50,18 @@
 #define TOUCH_CS_PORT PORT_B
 #define TOUCH_CS_PIN 8
 
+// TOUCH_IRQ: D3 (PA09), XPT2046 PENIRQ, low while touched. With it wired
+// an untouched panel is not polled over SPI and a touch ends idle sleep.
+#define TOUCH_IRQ_WIRED 0
+#define TOUCH_IRQ_PORT PORT_A
+#define TOUCH_IRQ_PIN 9
+
+// ===================================
+// SPI Clock (BAUD = 48 MHz / (2 * f) - 1)
+// ===================================
+#define SPI_BAUD_WRITE 1 // 12 MHz for commands and pixel writes
+#define SPI_BAUD_READ 3  // 6 MHz, the ILI9341 read cycle is much slower
+
 // ===================================
 // Screen Dimensions
 // ===================================
@@ -75,7 +87,12 @@
 #define ILI9341_CASET 0x2A
 #define ILI9341_PASET 0x2B
 #define ILI9341_RAMWR 0x2C
+#define ILI9341_RAMRD 0x2E
+#define ILI9341_VSCRDEF 0x33
+#define ILI9341_IDMOFF 0x38
+#define ILI9341_IDMON 0x39
 #define ILI9341_MADCTL 0x36
+#define ILI9341_VSCRSADD 0x37
 #define ILI9341_PIXFMT 0x3A
 #define ILI9341_FRMCTR1 0xB1
 #define ILI9341_PWCTR1 0xC0
@@ -122,9 +139,128 @@
 // ===================================
 #define MAX_BUTTONS 12
 #define MAX_VALUES 8
+#define MAX_VALUE_TEXT_LEN 8
 #define MAX_ALERT_LEN 32
-#define TOUCH_DEBOUNCE_MS 200
+#define BOOT_STATUS_LEN 20
 #define ALERT_TIMEOUT_MS 3000
 #define SENSOR_UPDATE_MS 2000
+#define RENDER_BUDGET_US 8000   // Page drawing per frame before yielding
+#define PAGE_ARENA_SIZE 4096    // RAM shared by whichever page is visible
+#define ALERT_HEIGHT 30
+#define ALERT_QUEUE_SIZE 4      // Pending alerts behind the visible one
+#define ALERT_SAVE_RUNS 384     // RLE runs saved under the banner (4 bytes each)
+
+// ===================================
+// Touch Input / Gestures
+// ===================================
+#define INPUT_QUEUE_SIZE 16     // Raw samples and recognized gestures
+#define TOUCH_RELEASE_MS 40     // No-contact time before a release is reported
+#define TOUCH_SLOP_PX 10        // Movement before a press becomes a drag
+#define LONG_PRESS_MS 600
+#define FLING_MIN_VELOCITY 400  // px/s at release to count as a fling
+#define VELOCITY_WINDOW_MS 80   // History used for release velocity
+
+// ===================================
+// Task Scheduler
+// ===================================
+#define MAX_TASKS 12
+#define UI_FRAME_MS 16          // UI frame slot (~60 Hz)
+#define TOUCH_SAMPLE_MS 4       // Touch sampling between frames
+#define BOOT_POLL_MS 50         // Background boot stages / header progress
+#define GPS_POLL_MS 10          // Serial1 drain / GPS state machine
+#define GPS_UI_REFRESH_MS 3000
+#define GPS_DEBUG_LOOP_MS 1000  // GPS debug page latency rows; GPS fields redraw on change
+#define SCHED_STATS_MS 10000    // Statistics dump over SerialUSB (0 = off)
+#define SCHED_HIST_BUCKETS 24   // log2 run-time buckets: [1,2) us ... >= 8.4 s
+#define SCHED_STALL_US 50000    // A task run this long froze the UI visibly
+#define WATCHDOG_ENABLED 0      // 1 = reset after ~4 s without a loop() pass
+
+// ===================================
+// Power Management
+// ===================================
+#define POWER_MIN_SLEEP_US 200  // Shorter gaps are not worth a sleep
+#define DISPLAY_IDLE_MS 30000   // No input for this long -> panel idle mode
+#define POWER_REPORT_MS 5000    // Simulator only, the firmware reports with its stats
+
+// ===================================
+// A9G AT Command Engine
+// ===================================
+#define AT_QUEUE_SIZE 4
+#define AT_CMD_LEN 112          // Longest command is the HTTP URL parameter
+#define AT_LINE_LEN 128         // "+GPSRD:" + an 82-char sentence fits
+#define AT_RESPONSE_LEN 256     // Longest expected reply is an HTTPREAD body
+#define UART_RX_RING_SIZE 2048  // Serial1 DMA ring, ~178 ms of 115200 baud (power of 2)
+#define A9G_FAST_BAUD 0         // Nonzero: AT+IPR to this rate once the GPS is up
+#define NMEA_FIELD_LEN 16       // Longest NMEA field ("dddmm.mmmmm", hhmmss.sss) + NUL
+
+// ===================================
+// GPS Duty Cycle
+// ===================================
+#define GPS_POLICY_MS 1000      // Power policy evaluation period
+#define GPS_SLOW_RD_S 10        // NMEA period (AT+GPSRD) while stationary
+#define GPS_STILL_M 15          // Fixes within this of each other count as not moving
+#define GPS_MOVE_KMH 3.0f       // Reported speed that counts as moving
+#define GPS_GOOD_HDOP 2.0f      // Fix worth caching: HDOP at most this...
+#define GPS_GOOD_SATS 5         // ...from at least this many satellites
+#define GPS_STILL_MS 60000      // Stationary this long: TRACK -> SLOW
+#define GPS_SLEEP_MS 300000     // Stationary with a good fix this long: receiver off
+#define GPS_OFF_MS 600000       // Receiver off this long: wake to check for movement
+#define GPS_ACQUIRE_MS 300000   // No fix after this long on: off until the next wake
+#define GPS_USER_HOLD_MS 120000 // TRACK kept this long after a user request
+
+// ===================================
+// GPS Start Assistance
+// ===================================
+#define GPS_LAST_FILE "gps_last.txt" // Last fix "seconds,lat,lon,alt", read back at boot
+#define GPS_LAST_SAVE_MS 600000 // Rewritten at most this often while fixes keep coming
+#define GPS_WARM_MAX_MS 7200000 // Power-on this soon after a fix counts as warm (ephemeris ~4 h)
+#define GPS_AGPS 1              // Nonzero: AT+AGPS=1 over GPRS for cold starts
+#define GPS_AGPS_RETRY_MS 15000 // Cold and not attached to GPRS: check again this often
+#define GPS_AGPS_TIMEOUT_MS 30000 // AT+AGPS=1 downloads the assistance data
+
+// ===================================
+// Cell Location Fallback
+// ===================================
+#define GPS_LBS 1               // Nonzero: AT+LOCATION=1 (cell towers) while there is no fix
+#define GPS_LBS_ACCURACY_M 1000 // Reported accuracy of a cell position (not in the reply)
+#define GPS_LBS_TIMEOUT_MS 10000 // The module asks a location server over GPRS
+#define GPS_LBS_RETRY_MS 20000  // After a failed request
+#define GPS_LBS_REFRESH_MS 300000 // After a good one, while still without a fix
+#define GPS_UERE_M 5            // Metres of error per unit HDOP for a GNSS fix
+
+// ===================================
+// GPS Track Log
+// ===================================
+#define TRACK_FILE "track.bin"
+#define TRACK_SYNC_MS 30000     // Partly filled block rewritten on the card at most this late
+#define TRACK_INDEX_SPAN 32     // Data blocks per index block (16 KB of track)
+#define TRACK_SIMPLIFY_CM 300   // Largest distance of a dropped fix from the stored track
+#define TRACK_SIMPLIFY_WINDOW 32 // Fixes between stored points at most (8 bytes each)
+#define TRACK_SIMPLIFY_MAX_S 120 // Longest time between stored points
+
+// ===================================
+// Background Work Queue
+// ===================================
+#define WORK_QUEUE_SIZE 8
+#define WORK_SLICE_US 2000      // Longest a work item may run per idle pass
+#define WORK_MIN_SLACK_US 500   // Idle gaps shorter than this are left alone
+#define WORK_STARVE_US 100000   // Item still waiting this long for slack counts as starved
+
+// ===================================
+// Performance Instrumentation
+// ===================================
+#ifndef PERF_ENABLED
+#define PERF_ENABLED 0          // 1 = driver counters and zone timers
+#endif
+#define PERF_REPORT_MS 1000
+
+// ===================================
+// Serial Console / Screenshots
+// ===================================
+#define CONSOLE_POLL_MS 20
+#define CONSOLE_LINE_LEN 48
+#define MAX_CONSOLE_COMMANDS 8
+#define SHOT_BAND_LINES 2       // Lines read back per band (~2.5 ms at 6 MHz)
+#define SHOT_BAND_MS 4          // Band task period, it still waits for slack
 
 #endif // CONFIG_H
@@ -0,0 +1,130 @@
+/**
+ * @file console.cpp
+ * @brief Line-Based Command Console Implementation
+ */
+
+#include "console.h"
+
+// ===================================
+// Command Table
+// ===================================
+
+typedef struct
+{
+    const char *name;
+    void (*fn)(const char *args);
+    const char *help;
+} ConsoleCommand;
+
+static ConsoleCommand commands[MAX_CONSOLE_COMMANDS];
+static int commandCount = 0;
+
+static char line[CONSOLE_LINE_LEN];
+static uint8_t lineLen = 0;
+static bool lineOverflow = false;
+
+bool console_addCommand(const char *name, void (*fn)(const char *args), const char *help)
+{
+    if (commandCount >= MAX_CONSOLE_COMMANDS || fn == NULL)
+    {
+        return false;
+    }
+    commands[commandCount].name = name;
+    commands[commandCount].fn = fn;
+    commands[commandCount].help = help;
+    commandCount++;
+    return true;
+}
+
+// ===================================
+// Dispatch
+// ===================================
+
+static void console_help(void)
+{
+    SerialUSB.println(F("Commands:"));
+    for (int i = 0; i < commandCount; i++)
+    {
+        char text[64];
+        snprintf(text, sizeof(text), "  %-8s %s", commands[i].name, commands[i].help);
+        SerialUSB.println(text);
+    }
+}
+
+static void console_dispatch(char *text)
+{
+    while (*text == ' ')
+    {
+        text++;
+    }
+    if (*text == '\0')
+    {
+        return;
+    }
+
+    char *args = strchr(text, ' ');
+    if (args != NULL)
+    {
+        *args++ = '\0';
+        while (*args == ' ')
+        {
+            args++;
+        }
+    }
+    else
+    {
+        args = text + strlen(text);
+    }
+
+    if (strcmp(text, "help") == 0)
+    {
+        console_help();
+        return;
+    }
+    for (int i = 0; i < commandCount; i++)
+    {
+        if (strcmp(text, commands[i].name) == 0)
+        {
+            commands[i].fn(args);
+            return;
+        }
+    }
+
+    SerialUSB.print(F("Unknown command: "));
+    SerialUSB.println(text);
+}
+
+void console_poll(void)
+{
+    while (SerialUSB.available() > 0)
+    {
+        int c = SerialUSB.read();
+        if (c < 0)
+        {
+            break;
+        }
+
+        if (c == '\r' || c == '\n')
+        {
+            line[lineLen] = '\0';
+            if (lineOverflow)
+            {
+                SerialUSB.println(F("Console line too long"));
+            }
+            else
+            {
+                console_dispatch(line);
+            }
+            lineLen = 0;
+            lineOverflow = false;
+        }
+        else if (lineLen < CONSOLE_LINE_LEN - 1)
+        {
+            line[lineLen++] = (char)c;
+        }
+        else
+        {
+            lineOverflow = true;
+        }
+    }
+}
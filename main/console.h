@@ -0,0 +1,36 @@
+/**
+ * @file console.h
+ * @brief Line-Based Command Console on SerialUSB
+ *
+ * Collects characters from SerialUSB into a line and, on newline, runs the
+ * command whose name matches the first word. The rest of the line is
+ * passed to the handler as its argument string. "help" lists commands.
+ */
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===================================
+// Console Functions
+// ===================================
+
+/**
+ * @brief Register a console command
+ * @param name Command word (must stay valid)
+ * @param fn Handler, receives the text after the command word ("" if none)
+ * @param help One-line description for "help"
+ * @return false if the command table is full
+ */
+bool console_addCommand(const char *name, void (*fn)(const char *args), const char *help);
+
+/**
+ * @brief Read pending input and run any completed command
+ *
+ * Non-blocking, run as a scheduler task every CONSOLE_POLL_MS.
+ */
+void console_poll(void);
+
+#endif // CONSOLE_H
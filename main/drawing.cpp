@@ -4,6 +4,29 @@
 #include <stdlib.h> // For abs()
 #include "fonts_pro.h" // Ensure this is included
 
+// ===================================
+// Clipping
+// ===================================
+
+static int16_t clipX0 = 0;
+static int16_t clipY0 = 0;
+static int16_t clipX1 = SCREEN_WIDTH;  // Exclusive
+static int16_t clipY1 = SCREEN_HEIGHT; // Exclusive
+
+void draw_setClip(int16_t x, int16_t y, int16_t w, int16_t h) {
+    clipX0 = (x < 0) ? 0 : x;
+    clipY0 = (y < 0) ? 0 : y;
+    clipX1 = (x + w > SCREEN_WIDTH) ? SCREEN_WIDTH : x + w;
+    clipY1 = (y + h > SCREEN_HEIGHT) ? SCREEN_HEIGHT : y + h;
+}
+
+void draw_clearClip(void) {
+    clipX0 = 0;
+    clipY0 = 0;
+    clipX1 = SCREEN_WIDTH;
+    clipY1 = SCREEN_HEIGHT;
+}
+
 // ===================================
 // Basic Drawing Primitives
 // ===================================
@@ -18,18 +41,18 @@ void draw_fillScreen(uint16_t color) {
 }
 
 void draw_pixel(int16_t x, int16_t y, uint16_t color) {
-    if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) return;
+    if (x < clipX0 || x >= clipX1 || y < clipY0 || y >= clipY1) return;
     tft_setWindow(x, y, x, y);
     tft_writeData16(color);
 }
 
 void draw_fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
-    if (x >= SCREEN_WIDTH || y >= SCREEN_HEIGHT) return;
+    if (x >= clipX1 || y >= clipY1) return;
     if (w <= 0 || h <= 0) return;
-    if (x < 0) { w += x; x = 0; }
-    if (y < 0) { h += y; y = 0; }
-    if (x + w > SCREEN_WIDTH) w = SCREEN_WIDTH - x;
-    if (y + h > SCREEN_HEIGHT) h = SCREEN_HEIGHT - y;
+    if (x < clipX0) { w -= clipX0 - x; x = clipX0; }
+    if (y < clipY0) { h -= clipY0 - y; y = clipY0; }
+    if (x + w > clipX1) w = clipX1 - x;
+    if (y + h > clipY1) h = clipY1 - y;
     if (w <= 0 || h <= 0) return;
 
     tft_setWindow(x, y, x + w - 1, y + h - 1);
@@ -68,6 +91,56 @@ void draw_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
     }
 }
 
+// ===================================
+// Save-Under (Display RAM Read-Back)
+// ===================================
+
+bool draw_saveUnder(SaveUnder *save, int16_t x, int16_t y, int16_t w, int16_t h) {
+    save->x = x;
+    save->y = y;
+    save->w = w;
+    save->h = h;
+    save->used = 0;
+    save->valid = false;
+    if (w <= 0 || h <= 0 || save->capacity == 0) return false;
+
+    tft_beginRead(x, y, x + w - 1, y + h - 1);
+    PixelRun *run = NULL;
+    for (int32_t i = 0; i < (int32_t)w * h; i++) {
+        uint16_t color = tft_readColor();
+        if (run != NULL && run->color == color && run->count < 0xFFFF) {
+            run->count++;
+            continue;
+        }
+        if (save->used >= save->capacity) {
+            tft_endRead(); // Too busy to keep, caller falls back to a redraw
+            return false;
+        }
+        run = &save->runs[save->used++];
+        run->count = 1;
+        run->color = color;
+    }
+    tft_endRead();
+
+    save->valid = true;
+    return true;
+}
+
+bool draw_restoreUnder(SaveUnder *save) {
+    if (!save->valid) return false;
+    save->valid = false;
+
+    tft_setWindow(save->x, save->y, save->x + save->w - 1, save->y + save->h - 1);
+    tft_beginWrite();
+    for (uint16_t r = 0; r < save->used; r++) {
+        for (uint16_t i = 0; i < save->runs[r].count; i++) {
+            tft_writeColor(save->runs[r].color);
+        }
+    }
+    tft_endWrite();
+    return true;
+}
+
 // ===================================
 // Advanced Shapes (Rounded Rects)
 // ===================================
@@ -171,11 +244,64 @@ int16_t get_GFXtextWidth(const char *str, const GFXfont *font) {
     return w;
 }
 
+int16_t get_GFXcharCellWidth(char c, const GFXfont *font) {
+    uint8_t first = pgm_read_byte(&font->first);
+    uint8_t last = pgm_read_byte(&font->last);
+    if ((uint8_t)c < first || (uint8_t)c > last) return 0;
+
+    GFXglyph *glyph = &(((GFXglyph *)pgm_read_ptr(&font->glyph))[(uint8_t)c - first]);
+    int16_t ink = (int8_t)pgm_read_byte(&glyph->xOffset) + pgm_read_byte(&glyph->width);
+    int16_t xa = pgm_read_byte(&glyph->xAdvance);
+    return (ink > xa) ? ink : xa;
+}
+
+void draw_GFXcharCell(int16_t x, int16_t y, int16_t cellW, int16_t cellH, char c,
+                      const GFXfont *font, uint16_t fg, uint16_t bg) {
+    if (cellW <= 0 || cellH <= 0) return;
+    if (x < clipX0 || y < clipY0 || x + cellW > clipX1 || y + cellH > clipY1) return;
+
+    uint8_t first = pgm_read_byte(&font->first);
+    uint8_t last = pgm_read_byte(&font->last);
+
+    // Unknown characters render as an empty cell
+    uint16_t bo = 0;
+    uint8_t w = 0, h = 0;
+    int8_t xo = 0, yo = 0;
+    if ((uint8_t)c >= first && (uint8_t)c <= last) {
+        GFXglyph *glyph = &(((GFXglyph *)pgm_read_ptr(&font->glyph))[(uint8_t)c - first]);
+        bo = pgm_read_word(&glyph->bitmapOffset);
+        w  = pgm_read_byte(&glyph->width);
+        h  = pgm_read_byte(&glyph->height);
+        xo = (int8_t)pgm_read_byte(&glyph->xOffset);
+        yo = (int8_t)pgm_read_byte(&glyph->yOffset);
+    }
+    uint8_t *bitmap = (uint8_t *)pgm_read_ptr(&font->bitmap);
+
+    // One window for the whole cell, pixels streamed row by row
+    tft_setWindow(x, y, x + cellW - 1, y + cellH - 1);
+    tft_beginWrite();
+    for (int16_t yy = 0; yy < cellH; yy++) {
+        int16_t gy = yy - yo;
+        for (int16_t xx = 0; xx < cellW; xx++) {
+            int16_t gx = xx - xo;
+            uint16_t color = bg;
+            if (gy >= 0 && gy < h && gx >= 0 && gx < w) {
+                uint16_t bit = gy * w + gx;
+                if (pgm_read_byte(&bitmap[bo + (bit >> 3)]) & (0x80 >> (bit & 7))) {
+                    color = fg;
+                }
+            }
+            tft_writeColor(color);
+        }
+    }
+    tft_endWrite();
+}
+
 // ===================================
 // UI Component Drawing
 // ===================================
 
-void draw_card_modern(int16_t x, int16_t y, int16_t w, int16_t h, const char *label, int16_t value, uint16_t color)
+void draw_cardFrame(int16_t x, int16_t y, int16_t w, int16_t h, const char *label, uint16_t color)
 {
     // 1. Shadow (Simple offset rect)
     draw_roundedRect(x + 4, y + 4, w, h, 10, COLOR_LIGHTGRAY);
@@ -189,6 +315,11 @@ void draw_card_modern(int16_t x, int16_t y, int16_t w, int16_t h, const char *la
     
     // 4. Label (using new Font!)
     draw_GFXtext(x + 10, y + 18, label, &MyFontPro, COLOR_WHITE); // <--- FIXED: uses MyFontPro
+}
+
+void draw_card_modern(int16_t x, int16_t y, int16_t w, int16_t h, const char *label, int16_t value, uint16_t color)
+{
+    draw_cardFrame(x, y, w, h, label, color);
     
     // 5. Value
     char valStr[10];
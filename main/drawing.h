@@ -18,6 +18,37 @@ void draw_line(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
 void draw_hLine(int16_t x, int16_t y, int16_t w, uint16_t color);
 void draw_vLine(int16_t x, int16_t y, int16_t h, uint16_t color);
 
+/**
+ * @brief Restrict all drawing to a rectangle (intersected with the screen)
+ */
+void draw_setClip(int16_t x, int16_t y, int16_t w, int16_t h);
+
+/**
+ * @brief Remove the clip rectangle (draw to the whole screen)
+ */
+void draw_clearClip(void);
+
+// ===================================
+// Save-Under (Display RAM Read-Back)
+// ===================================
+
+/**
+ * @brief Read a rectangle back from display RAM before covering it
+ *
+ * Ignores the clip rectangle. Runs are in display RAM order, so the
+ * rectangle must not lie in a hardware scroll area that moves before
+ * the restore.
+ * @param save Buffer with runs/capacity set by the caller
+ * @return false if the pixels did not fit in save->capacity runs
+ */
+bool draw_saveUnder(SaveUnder *save, int16_t x, int16_t y, int16_t w, int16_t h);
+
+/**
+ * @brief Write saved pixels back and invalidate the buffer
+ * @return false if there was nothing valid to restore
+ */
+bool draw_restoreUnder(SaveUnder *save);
+
 // ===================================
 // Advanced Shapes (New)
 // ===================================
@@ -57,6 +88,28 @@ void draw_GFXtext(int16_t x, int16_t y, const char *str, const GFXfont *font, ui
  */
 int16_t get_GFXtextWidth(const char *str, const GFXfont *font);
 
+/**
+ * @brief Width of the cell a glyph occupies (max of advance and ink extent)
+ */
+int16_t get_GFXcharCellWidth(char c, const GFXfont *font);
+
+/**
+ * @brief Blit one glyph cell in a single window write
+ *
+ * Every pixel of the cell is written (glyph in fg, rest in bg), so the cell
+ * fully replaces whatever was there before without a separate clear.
+ * @param x Left X of the cell
+ * @param y Top Y of the cell (same origin as draw_GFXtext)
+ * @param cellW Cell width, glyph ink beyond it is clipped
+ * @param cellH Cell height, usually font->yAdvance
+ * @param c Character to draw
+ * @param font Pointer to the GFXfont structure
+ * @param fg Glyph color
+ * @param bg Cell background color
+ */
+void draw_GFXcharCell(int16_t x, int16_t y, int16_t cellW, int16_t cellH, char c,
+                      const GFXfont *font, uint16_t fg, uint16_t bg);
+
 // ===================================
 // UI Component Drawing
 // ===================================
@@ -67,6 +120,9 @@ void draw_card(int16_t x, int16_t y, int16_t w, int16_t h, const char *label, in
 // MODERN (Use this for home screen)
 void draw_card_modern(int16_t x, int16_t y, int16_t w, int16_t h, const char *label, int16_t value, uint16_t color);
 
+// Card without the value, for values rendered by the data binding system
+void draw_cardFrame(int16_t x, int16_t y, int16_t w, int16_t h, const char *label, uint16_t color);
+
 void draw_button(UIButton *btn);
 void draw_icon(int16_t x, int16_t y, int16_t size, uint16_t color);
 void draw_iconBitmap(int16_t x, int16_t y, const unsigned char *bitmap, int16_t w, int16_t h, uint16_t color);
@@ -6,10 +6,17 @@
 #include "file_browser.h"
 
 FileBrowser::FileBrowser() {
+    files = &scratch;
+    windowCapacity = 1;
+    windowStart = 0;
+    windowCount = 0;
     fileCount = 0;
     scrollOffset = 0;
     selectedIndex = -1;
-    currentPath = "/";
+    strcpy(currentPath, "/");
+    scanning = false;
+    readOpen = false;
+    readIndex = 0;
 }
 
 bool FileBrowser::begin(uint8_t csPin) {
@@ -22,46 +29,85 @@ bool FileBrowser::begin(uint8_t csPin) {
     }
     
     SerialUSB.println(F("FileBrowser: SD.begin() SUCCESS"));
-    SerialUSB.println(F("FileBrowser: Opening root directory..."));
-    
-    openDirectory("/");
-    
-    SerialUSB.print(F("FileBrowser: Found "));
-    SerialUSB.print(fileCount);
-    SerialUSB.println(F(" files/folders"));
-    
     return true;
 }
 
+void FileBrowser::scanRoot() {
+    SerialUSB.println(F("FileBrowser: Scanning root directory..."));
+    if (startScan("/")) {
+        if (!work_submit("sd-scan", scanWork, this)) {
+            // Queue full: count it now rather than leave the list empty
+            while (scanStep(micros())) {
+            }
+        }
+    }
+}
+
 void FileBrowser::openDirectory(const char* path) {
     SerialUSB.print(F("FileBrowser: Opening directory: "));
     SerialUSB.println(path);
     
+    // A user tap wins over a background scan; finish this one right away.
+    // scanStep() handles at least one entry per call, so an expired
+    // deadline still makes progress.
+    if (startScan(path)) {
+        while (scanStep(micros())) {
+        }
+    }
+}
+
+WorkStatus FileBrowser::scanWork(void* ctx, uint32_t deadlineUs) {
+    FileBrowser* browser = (FileBrowser*)ctx;
+    return browser->scanStep(deadlineUs) ? WORK_MORE : WORK_DONE;
+}
+
+bool FileBrowser::startScan(const char* path) {
+    if (scanning) {
+        scanDir.close();
+        scanning = false;
+    }
+    closeReader();
+    
+    windowStart = 0;
+    windowCount = 0;
     fileCount = 0;
     scrollOffset = 0;
     selectedIndex = -1;
-    currentPath = String(path);
+    if (path != currentPath) {
+        strncpy(currentPath, path, FILE_PATH_MAX_LEN - 1);
+        currentPath[FILE_PATH_MAX_LEN - 1] = '\0';
+    }
     
-    File dir = SD.open(path);
-    if (!dir) {
+    scanDir = SD.open(path);
+    if (!scanDir) {
         SerialUSB.println(F("FileBrowser: ERROR - Failed to open directory!"));
-        return;
+        return false;
     }
     
-    if (!dir.isDirectory()) {
+    if (!scanDir.isDirectory()) {
         SerialUSB.println(F("FileBrowser: ERROR - Path is not a directory!"));
-        dir.close();
-        return;
+        scanDir.close();
+        return false;
     }
     
     SerialUSB.println(F("FileBrowser: Directory opened, reading entries..."));
+    scanning = true;
+    return true;
+}
+
+// Count entries until the deadline, caching the first window
+bool FileBrowser::scanStep(uint32_t deadlineUs) {
+    if (!scanning) return false;
     
-    // Read all files
-    while (fileCount < MAX_FILES_DISPLAY) {
-        File entry = dir.openNextFile();
+    do {
+        File entry = scanDir.openNextFile();
         if (!entry) {
             SerialUSB.println(F("FileBrowser: No more entries"));
-            break;
+            scanDir.close();
+            scanning = false;
+            SerialUSB.print(F("FileBrowser: Total entries loaded: "));
+            SerialUSB.println(fileCount);
+            return false;
         }
         
         const char* entryName = entry.name();
@@ -69,49 +115,119 @@ void FileBrowser::openDirectory(const char* path) {
         SerialUSB.print(fileCount);
         SerialUSB.print(F(": "));
         SerialUSB.print(entryName);
-        
-        strncpy(files[fileCount].name, entryName, FILE_NAME_MAX_LEN - 1);
-        files[fileCount].name[FILE_NAME_MAX_LEN - 1] = '\0';
-        files[fileCount].isDirectory = entry.isDirectory();
-        files[fileCount].size = entry.size();
-        
-        if (files[fileCount].isDirectory) {
+        if (entry.isDirectory()) {
             SerialUSB.println(F(" [DIR]"));
         } else {
             SerialUSB.print(F(" ("));
-            SerialUSB.print(files[fileCount].size);
+            SerialUSB.print((uint32_t)entry.size());
             SerialUSB.println(F(" bytes)"));
         }
         
+        // Extend the window only while it ends at the scan position; a
+        // window attached mid-scan is filled by loadWindow() instead
+        if (fileCount == windowStart + windowCount && windowCount < windowCapacity) {
+            FileEntry* slot = &files[windowCount++];
+            strncpy(slot->name, entryName, FILE_NAME_MAX_LEN - 1);
+            slot->name[FILE_NAME_MAX_LEN - 1] = '\0';
+            slot->isDirectory = entry.isDirectory();
+            slot->size = entry.size();
+        }
+        
         entry.close();
         fileCount++;
-    }
+    } while ((int32_t)(deadlineUs - micros()) > 0);
     
-    dir.close();
-    
-    SerialUSB.print(F("FileBrowser: Total entries loaded: "));
-    SerialUSB.println(fileCount);
+    return true;
 }
 
 void FileBrowser::goUp() {
     SerialUSB.println(F("FileBrowser: Going up one directory..."));
     
-    if (currentPath.length() <= 1) {
+    if (!canGoUp()) {
         SerialUSB.println(F("FileBrowser: Already at root, cannot go up"));
         return;
     }
     
-    int lastSlash = currentPath.lastIndexOf('/');
-    if (lastSlash > 0) {
-        currentPath = currentPath.substring(0, lastSlash);
+    // Truncate in place at the last separator
+    char* lastSlash = strrchr(currentPath, '/');
+    if (lastSlash && lastSlash != currentPath) {
+        *lastSlash = '\0';
     } else {
-        currentPath = "/";
+        strcpy(currentPath, "/");
     }
     
     SerialUSB.print(F("FileBrowser: New path: "));
     SerialUSB.println(currentPath);
     
-    openDirectory(currentPath.c_str());
+    openDirectory(currentPath);
+}
+
+void FileBrowser::attachWindow(FileEntry* buffer, int capacity) {
+    if (!buffer || capacity < 1) return;
+    files = buffer;
+    windowCapacity = capacity;
+    windowStart = 0;
+    windowCount = 0; // Filled on the next getFile()
+}
+
+void FileBrowser::detachWindow() {
+    files = &scratch;
+    windowCapacity = 1;
+    windowStart = 0;
+    windowCount = 0;
+    closeReader();
+}
+
+void FileBrowser::closeReader() {
+    if (readOpen) {
+        readDir.close();
+        readOpen = false;
+    }
+}
+
+void FileBrowser::loadWindow(int first) {
+    if (first > fileCount - windowCapacity) first = fileCount - windowCapacity;
+    if (first < 0) first = 0;
+    
+    int oldStart = windowStart;
+    int oldEnd = windowStart + windowCount;
+    windowStart = first;
+    windowCount = 0;
+    
+    // Directory entries are only reachable in order. The reader stays
+    // where the last window ended, so scrolling on keeps the overlap and
+    // reads only the new entries; a window further back starts again
+    // from the top.
+    if (readOpen && readIndex == oldEnd && first >= oldStart && first < oldEnd) {
+        windowCount = oldEnd - first;
+        memmove(files, files + (first - oldStart), windowCount * sizeof(FileEntry));
+    } else if (!readOpen) {
+        readDir = SD.open(currentPath);
+        if (!readDir) {
+            SerialUSB.println(F("FileBrowser: ERROR - Failed to reopen directory!"));
+            return;
+        }
+        readOpen = true;
+        readIndex = 0;
+    } else if (first < readIndex) {
+        readDir.rewindDirectory();
+        readIndex = 0;
+    }
+    
+    while (windowCount < windowCapacity) {
+        File entry = readDir.openNextFile();
+        if (!entry) break;
+        
+        if (readIndex >= first) {
+            FileEntry* slot = &files[windowCount++];
+            strncpy(slot->name, entry.name(), FILE_NAME_MAX_LEN - 1);
+            slot->name[FILE_NAME_MAX_LEN - 1] = '\0';
+            slot->isDirectory = entry.isDirectory();
+            slot->size = entry.size();
+        }
+        entry.close();
+        readIndex++;
+    }
 }
 
 FileEntry* FileBrowser::getFile(int index) {
@@ -120,7 +236,17 @@ FileEntry* FileBrowser::getFile(int index) {
         SerialUSB.println(index);
         return nullptr;
     }
-    return &files[index];
+    if (index < windowStart || index >= windowStart + windowCount) {
+        // Keep a few entries behind the requested one for reverse
+        // scrolling; scrolling back, put it near the end instead, as each
+        // backward move rereads the directory from the top
+        if (index < windowStart) loadWindow(index - windowCapacity + windowCapacity / 4);
+        else loadWindow(index - windowCapacity / 4);
+        if (index < windowStart || index >= windowStart + windowCount) {
+            return nullptr;
+        }
+    }
+    return &files[index - windowStart];
 }
 
 void FileBrowser::scroll(int delta) {
@@ -150,16 +276,23 @@ void FileBrowser::selectFile(int index) {
     
     selectedIndex = index;
     
+    FileEntry* entry = getFile(index);
+    if (!entry) return;
+    
     SerialUSB.print(F("FileBrowser: Selected: "));
-    SerialUSB.println(files[index].name);
+    SerialUSB.println(entry->name);
     
-    if (files[index].isDirectory) {
+    if (entry->isDirectory) {
         // Navigate into directory
         SerialUSB.println(F("FileBrowser: Entering directory..."));
-        String newPath = currentPath;
-        if (newPath != "/") newPath += "/";
-        newPath += String(files[index].name);
-        openDirectory(newPath.c_str());
+        char newPath[FILE_PATH_MAX_LEN];
+        int len = snprintf(newPath, sizeof(newPath), "%s%s%s", currentPath,
+                           canGoUp() ? "/" : "", entry->name);
+        if (len >= (int)sizeof(newPath)) {
+            SerialUSB.println(F("FileBrowser: ERROR - Path too long"));
+            return;
+        }
+        openDirectory(newPath);
     } else {
         SerialUSB.println(F("FileBrowser: File selected (not a directory)"));
     }
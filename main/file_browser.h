@@ -9,9 +9,10 @@
 #include <Arduino.h>
 #include <SD.h>
 #include "config.h"
+#include "workqueue.h"
 
-#define MAX_FILES_DISPLAY 20
 #define FILE_NAME_MAX_LEN 32
+#define FILE_PATH_MAX_LEN 128
 
 typedef struct {
     char name[FILE_NAME_MAX_LEN];
@@ -21,25 +22,51 @@ typedef struct {
 
 class FileBrowser {
 private:
-    FileEntry files[MAX_FILES_DISPLAY];
-    int fileCount;
+    FileEntry scratch;                  // One-entry window when nothing is attached
+    FileEntry* files;                   // Window of entries around the view
+    int windowCapacity;                 // Entries files[] can hold
+    int windowStart;                    // Directory index of files[0]
+    int windowCount;                    // Entries valid in files[]
+    int fileCount;                      // Entries in the whole directory
     int scrollOffset;
     int selectedIndex;
-    String currentPath;
+    char currentPath[FILE_PATH_MAX_LEN];
+    File scanDir;                       // Directory being counted, open while scanning
+    bool scanning;
+    File readDir;                       // Directory the window is read from, kept open
+    bool readOpen;
+    int readIndex;                      // Directory index of readDir's next entry
+    
+    void loadWindow(int first);
+    void closeReader();
+    bool startScan(const char* path);
+    bool scanStep(uint32_t deadlineUs);
+    static WorkStatus scanWork(void* ctx, uint32_t deadlineUs);
     
 public:
     FileBrowser();
+    // Mounts the card only; the root directory is counted by scanRoot()
     bool begin(uint8_t csPin);
+    // Count the root directory in work-queue slices; the count grows
+    // while isScanning() is true
+    void scanRoot();
+    bool isScanning() { return scanning; }
     void openDirectory(const char* path);
     void goUp();
+    // The window buffer is lent by the visible page (from its arena) and
+    // must be detached before that memory is reused
+    void attachWindow(FileEntry* buffer, int capacity);
+    void detachWindow();
     int getFileCount() { return fileCount; }
     int getScrollOffset() { return scrollOffset; }
+    // Entries outside the cached window are loaded on demand; the pointer
+    // stays valid until the next getFile() call that moves the window.
     FileEntry* getFile(int index);
     void scroll(int delta);
     void selectFile(int index);
     int getSelectedIndex() { return selectedIndex; }
-    const char* getCurrentPath() { return currentPath.c_str(); }
-    bool canGoUp() { return currentPath.length() > 1; }
+    const char* getCurrentPath() { return currentPath; }
+    bool canGoUp() { return currentPath[1] != '\0'; }
 };
 
 #endif // FILE_BROWSER_H
\ No newline at end of file
@@ -0,0 +1,154 @@
+/**
+ * @file geo.cpp
+ * @brief Fixed-Point Coordinate Helpers Implementation
+ */
+
+#include "geo.h"
+
+// cos(0..90 degrees) in Q15
+static const uint16_t cosTableQ15[91] = {
+    32767, 32763, 32748, 32723, 32688, 32643, 32588, 32524, 32449, 32365,
+    32270, 32166, 32052, 31928, 31795, 31651, 31499, 31336, 31164, 30983,
+    30792, 30592, 30382, 30163, 29935, 29698, 29452, 29197, 28932, 28660,
+    28378, 28088, 27789, 27482, 27166, 26842, 26510, 26170, 25822, 25466,
+    25102, 24730, 24351, 23965, 23571, 23170, 22763, 22348, 21926, 21498,
+    21063, 20622, 20174, 19720, 19261, 18795, 18324, 17847, 17364, 16877,
+    16384, 15886, 15384, 14876, 14365, 13848, 13328, 12803, 12275, 11743,
+    11207, 10668, 10126, 9580, 9032, 8481, 7927, 7371, 6813, 6252,
+    5690, 5126, 4560, 3993, 3425, 2856, 2286, 1715, 1144, 572,
+    0,
+};
+
+// One degree of arc on the mean Earth radius; 1e-7 degree is 1.11 cm
+#define GEO_M_PER_DEG 111195L
+
+int32_t geo_parseE7(const char *s, const char **end)
+{
+    bool neg = (*s == '-');
+    if (neg || *s == '+')
+    {
+        s++;
+    }
+
+    int32_t deg = 0;
+    while (*s >= '0' && *s <= '9')
+    {
+        deg = deg * 10 + (*s++ - '0');
+    }
+
+    int32_t frac = 0;
+    int32_t scale = GEO_E7;
+    if (*s == '.')
+    {
+        s++;
+        while (*s >= '0' && *s <= '9')
+        {
+            if (scale > 1)
+            {
+                scale /= 10;
+                frac += (*s - '0') * scale;
+            }
+            s++;
+        }
+    }
+
+    if (end != NULL)
+    {
+        *end = s;
+    }
+    int32_t e7 = deg * GEO_E7 + frac;
+    return neg ? -e7 : e7;
+}
+
+int geo_formatE7(char *out, size_t outLen, int32_t e7, uint8_t decimals)
+{
+    static const int32_t pow10[8] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+    if (decimals > 7)
+    {
+        decimals = 7;
+    }
+
+    uint32_t mag = (e7 < 0) ? (uint32_t)(-(int64_t)e7) : (uint32_t)e7;
+    uint32_t unit = pow10[7 - decimals];
+    mag = (mag + unit / 2) / unit; // Round to the requested places
+
+    uint32_t deg = mag / pow10[decimals];
+    uint32_t frac = mag % pow10[decimals];
+    const char *sign = (e7 < 0 && mag != 0) ? "-" : "";
+    if (decimals == 0)
+    {
+        return snprintf(out, outLen, "%s%lu", sign, (unsigned long)deg);
+    }
+    return snprintf(out, outLen, "%s%lu.%0*lu", sign, (unsigned long)deg, decimals,
+                    (unsigned long)frac);
+}
+
+// cos(latitude) in Q15, linear between whole degrees
+static uint32_t geo_cosQ15(int32_t latE7)
+{
+    uint32_t a = (latE7 < 0) ? (uint32_t)(-latE7) : (uint32_t)latE7;
+    uint32_t deg = a / GEO_E7;
+    if (deg >= 90)
+    {
+        return 0;
+    }
+    uint32_t frac = (a % GEO_E7) / 1000; // 0..9999
+    uint32_t c0 = cosTableQ15[deg];
+    uint32_t c1 = cosTableQ15[deg + 1];
+    return c0 - (c0 - c1) * frac / 10000;
+}
+
+uint32_t geo_isqrt(uint64_t v)
+{
+    uint64_t root = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (v >= root + bit)
+        {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+void geo_offsetCm(int32_t latRef, int32_t lonRef, int32_t lat, int32_t lon,
+                  int32_t *eastCm, int32_t *northCm)
+{
+    int64_t dLat = (int64_t)lat - latRef;
+    int64_t dLon = (int64_t)lon - lonRef;
+    if (dLon > 180 * GEO_E7)
+    {
+        dLon -= (int64_t)360 * GEO_E7;
+    }
+    else if (dLon < -180 * GEO_E7)
+    {
+        dLon += (int64_t)360 * GEO_E7;
+    }
+
+    // East-west degrees shrink with the cosine of the mean latitude
+    int32_t midLat = (int32_t)(((int64_t)latRef + lat) / 2);
+    dLon = dLon * (int64_t)geo_cosQ15(midLat) >> 15;
+
+    *northCm = (int32_t)(dLat * GEO_M_PER_DEG / 100000);
+    *eastCm = (int32_t)(dLon * GEO_M_PER_DEG / 100000);
+}
+
+uint32_t geo_distanceM(int32_t latA, int32_t lonA, int32_t latB, int32_t lonB)
+{
+    // Centimetres, so the square root keeps sub-metre resolution
+    int32_t x, y;
+    geo_offsetCm(latA, lonA, latB, lonB, &x, &y);
+    uint64_t cm = geo_isqrt((uint64_t)((int64_t)x * x) + (uint64_t)((int64_t)y * y));
+    return (uint32_t)((cm + 50) / 100);
+}
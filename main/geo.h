@@ -0,0 +1,64 @@
+/**
+ * @file geo.h
+ * @brief Fixed-Point Coordinate Helpers
+ *
+ * Coordinates are int32 in units of 1e-7 degree (about 1.1 cm of
+ * latitude), from the NMEA parser through logging and display. The
+ * SAMD21 has no FPU, so parsing, printing and distance are done with
+ * integer arithmetic only.
+ */
+
+#ifndef GEO_H
+#define GEO_H
+
+#include <Arduino.h>
+
+#define GEO_E7 10000000L // Units per degree
+
+// ===================================
+// Geo Functions
+// ===================================
+
+/**
+ * @brief Parse decimal degrees ("-28.6139", "77.209000")
+ * @param s Text
+ * @param end Set to the first character not used (may be NULL)
+ * @return Degrees x 1e7; digits beyond the 7th decimal are truncated
+ */
+int32_t geo_parseE7(const char *s, const char **end);
+
+/**
+ * @brief Format degrees x 1e7 as decimal degrees
+ * @param out Output buffer
+ * @param outLen Size of out
+ * @param e7 Degrees x 1e7
+ * @param decimals Decimal places, 0-7 (rounded half away from zero)
+ * @return Characters written, as snprintf
+ */
+int geo_formatE7(char *out, size_t outLen, int32_t e7, uint8_t decimals);
+
+/**
+ * @brief Ground distance between two points
+ *
+ * Equirectangular approximation with a cosine table: within 0.5 % up to
+ * tens of kilometres, which covers fix-to-fix and track distances.
+ * @return Metres
+ */
+uint32_t geo_distanceM(int32_t latA, int32_t lonA, int32_t latB, int32_t lonB);
+
+/**
+ * @brief Position of a point on a flat local grid around a reference
+ *
+ * Same approximation as geo_distanceM, for geometry on short tracks.
+ * @param eastCm Centimetres east of the reference
+ * @param northCm Centimetres north of the reference
+ */
+void geo_offsetCm(int32_t latRef, int32_t lonRef, int32_t lat, int32_t lon,
+                  int32_t *eastCm, int32_t *northCm);
+
+/**
+ * @brief Integer square root, rounded down
+ */
+uint32_t geo_isqrt(uint64_t v);
+
+#endif // GEO_H
@@ -0,0 +1,330 @@
+/**
+ * @file input.cpp
+ * @brief Touch Input Pipeline Implementation
+ */
+
+#include "input.h"
+#include "touch_driver.h"
+
+// ===================================
+// Queues
+// ===================================
+
+static TouchSample sampleQueue[INPUT_QUEUE_SIZE];
+static uint8_t sampleHead = 0;
+static uint8_t sampleCount = 0;
+
+static UIEvent eventQueue[INPUT_QUEUE_SIZE];
+static uint8_t eventHead = 0;
+static uint8_t eventCount = 0;
+
+static InputStats stats;
+
+// ===================================
+// Sampler State
+// ===================================
+
+static bool contactDown = false;
+static int16_t contactX = -1;
+static int16_t contactY = -1;
+static uint32_t lastContactUs = 0;
+
+// ===================================
+// Recognizer State
+// ===================================
+
+typedef enum
+{
+    GESTURE_IDLE = 0,
+    GESTURE_PRESSED,
+    GESTURE_LONG_PRESSED,
+    GESTURE_DRAGGING
+} GestureState;
+
+#define VELOCITY_HISTORY 8
+
+static GestureState gestureState = GESTURE_IDLE;
+static int16_t startX, startY;
+static uint32_t startUs;
+static int16_t dragX, dragY; // Position of the last drag event
+
+static struct
+{
+    int16_t x;
+    int16_t y;
+    uint32_t timeUs;
+} history[VELOCITY_HISTORY];
+static uint8_t historyHead = 0;
+static uint8_t historyCount = 0;
+
+// ===================================
+// Queue Helpers
+// ===================================
+
+static void pushSample(TouchPhase phase, int16_t x, int16_t y, uint32_t timeUs)
+{
+    if (sampleCount >= INPUT_QUEUE_SIZE)
+    {
+        stats.dropped++;
+        return;
+    }
+    TouchSample *s = &sampleQueue[(sampleHead + sampleCount) % INPUT_QUEUE_SIZE];
+    s->phase = phase;
+    s->x = x;
+    s->y = y;
+    s->timeUs = timeUs;
+    sampleCount++;
+    stats.samples++;
+}
+
+static UIEvent *pushEvent(UIEventType type, int16_t x, int16_t y, uint32_t timeUs)
+{
+    if (eventCount >= INPUT_QUEUE_SIZE)
+    {
+        // Drop the oldest gesture, the newest reflects the finger best
+        eventHead = (eventHead + 1) % INPUT_QUEUE_SIZE;
+        eventCount--;
+    }
+    UIEvent *ev = &eventQueue[(eventHead + eventCount) % INPUT_QUEUE_SIZE];
+    memset(ev, 0, sizeof(UIEvent));
+    ev->type = type;
+    ev->x = x;
+    ev->y = y;
+    ev->startX = startX;
+    ev->startY = startY;
+    ev->timeUs = timeUs;
+    eventCount++;
+    return ev;
+}
+
+static void addHistory(int16_t x, int16_t y, uint32_t timeUs)
+{
+    history[historyHead].x = x;
+    history[historyHead].y = y;
+    history[historyHead].timeUs = timeUs;
+    historyHead = (historyHead + 1) % VELOCITY_HISTORY;
+    if (historyCount < VELOCITY_HISTORY)
+    {
+        historyCount++;
+    }
+}
+
+static int16_t clampVelocity(int32_t v)
+{
+    if (v > 32000) return 32000;
+    if (v < -32000) return -32000;
+    return (int16_t)v;
+}
+
+// Velocity over the last VELOCITY_WINDOW_MS of movement, in px/s
+static void computeVelocity(int16_t *vx, int16_t *vy)
+{
+    *vx = 0;
+    *vy = 0;
+    if (historyCount < 2)
+    {
+        return;
+    }
+
+    uint8_t newest = (historyHead + VELOCITY_HISTORY - 1) % VELOCITY_HISTORY;
+    uint8_t oldest = newest;
+    for (uint8_t i = 1; i < historyCount; i++)
+    {
+        uint8_t idx = (newest + VELOCITY_HISTORY - i) % VELOCITY_HISTORY;
+        if (history[newest].timeUs - history[idx].timeUs > VELOCITY_WINDOW_MS * 1000UL)
+        {
+            break;
+        }
+        oldest = idx;
+    }
+
+    uint32_t dtUs = history[newest].timeUs - history[oldest].timeUs;
+    if (dtUs == 0)
+    {
+        return;
+    }
+    *vx = clampVelocity((int32_t)(history[newest].x - history[oldest].x) * 1000000L / (int32_t)dtUs);
+    *vy = clampVelocity((int32_t)(history[newest].y - history[oldest].y) * 1000000L / (int32_t)dtUs);
+}
+
+// ===================================
+// Gesture Recognizer
+// ===================================
+
+static void recognize(const TouchSample *s)
+{
+    switch (s->phase)
+    {
+    case TOUCH_DOWN:
+        gestureState = GESTURE_PRESSED;
+        startX = s->x;
+        startY = s->y;
+        startUs = s->timeUs;
+        dragX = s->x;
+        dragY = s->y;
+        historyHead = 0;
+        historyCount = 0;
+        addHistory(s->x, s->y, s->timeUs);
+        break;
+
+    case TOUCH_MOVE:
+        addHistory(s->x, s->y, s->timeUs);
+        if (gestureState == GESTURE_PRESSED)
+        {
+            if (abs(s->x - startX) <= TOUCH_SLOP_PX && abs(s->y - startY) <= TOUCH_SLOP_PX)
+            {
+                break;
+            }
+            gestureState = GESTURE_DRAGGING;
+            pushEvent(UI_EVENT_DRAG_START, startX, startY, s->timeUs);
+        }
+        if (gestureState == GESTURE_DRAGGING)
+        {
+            UIEvent *ev = pushEvent(UI_EVENT_DRAG, s->x, s->y, s->timeUs);
+            ev->dx = s->x - dragX;
+            ev->dy = s->y - dragY;
+            dragX = s->x;
+            dragY = s->y;
+        }
+        break;
+
+    case TOUCH_UP:
+        if (gestureState == GESTURE_PRESSED)
+        {
+            pushEvent(UI_EVENT_TAP, startX, startY, s->timeUs);
+        }
+        else if (gestureState == GESTURE_DRAGGING)
+        {
+            int16_t vx, vy;
+            computeVelocity(&vx, &vy);
+
+            UIEvent *ev = pushEvent(UI_EVENT_DRAG_END, s->x, s->y, s->timeUs);
+            ev->vx = vx;
+            ev->vy = vy;
+
+            if (abs(vx) >= FLING_MIN_VELOCITY || abs(vy) >= FLING_MIN_VELOCITY)
+            {
+                ev = pushEvent(UI_EVENT_FLING, s->x, s->y, s->timeUs);
+                ev->vx = vx;
+                ev->vy = vy;
+            }
+        }
+        gestureState = GESTURE_IDLE;
+        break;
+    }
+}
+
+// Time-driven transitions that have no sample of their own
+static void recognizeTimeouts(void)
+{
+    if (gestureState == GESTURE_PRESSED &&
+        (uint32_t)(micros() - startUs) >= LONG_PRESS_MS * 1000UL)
+    {
+        gestureState = GESTURE_LONG_PRESSED;
+        pushEvent(UI_EVENT_LONG_PRESS, startX, startY, startUs + LONG_PRESS_MS * 1000UL);
+    }
+}
+
+// ===================================
+// Public API
+// ===================================
+
+void input_init(void)
+{
+    sampleHead = 0;
+    sampleCount = 0;
+    eventHead = 0;
+    eventCount = 0;
+    contactDown = false;
+    gestureState = GESTURE_IDLE;
+    memset(&stats, 0, sizeof(stats));
+}
+
+void input_poll(void)
+{
+    int16_t x, y;
+    uint32_t now = micros();
+
+    // PENIRQ is high with no finger on the panel, so skip the SPI reads
+    if (!contactDown && !touch_irqActive())
+    {
+        return;
+    }
+
+    if (touch_getPoint(&x, &y))
+    {
+        lastContactUs = now;
+        if (!contactDown)
+        {
+            contactDown = true;
+            pushSample(TOUCH_DOWN, x, y, now);
+        }
+        else if (x != contactX || y != contactY)
+        {
+            pushSample(TOUCH_MOVE, x, y, now);
+        }
+        contactX = x;
+        contactY = y;
+    }
+    else if (contactDown && now - lastContactUs >= TOUCH_RELEASE_MS * 1000UL)
+    {
+        // Resistive panels flicker, so a release needs a short quiet period
+        contactDown = false;
+        pushSample(TOUCH_UP, contactX, contactY, lastContactUs);
+    }
+}
+
+bool input_isTouching(void)
+{
+    return contactDown;
+}
+
+bool input_pending(void)
+{
+    return sampleCount > 0 || eventCount > 0;
+}
+
+bool input_nextEvent(UIEvent *ev)
+{
+    while (sampleCount > 0)
+    {
+        TouchSample s = sampleQueue[sampleHead];
+        sampleHead = (sampleHead + 1) % INPUT_QUEUE_SIZE;
+        sampleCount--;
+        recognize(&s);
+    }
+    recognizeTimeouts();
+
+    if (eventCount == 0)
+    {
+        return false;
+    }
+    *ev = eventQueue[eventHead];
+    eventHead = (eventHead + 1) % INPUT_QUEUE_SIZE;
+    eventCount--;
+    return true;
+}
+
+void input_recordLatency(const UIEvent *ev)
+{
+    uint32_t latency = (uint32_t)(micros() - ev->timeUs);
+    stats.events++;
+    stats.lastLatencyUs = latency;
+    if (latency > stats.maxLatencyUs)
+    {
+        stats.maxLatencyUs = latency;
+    }
+    if (stats.events == 1)
+    {
+        stats.avgLatencyUs = latency;
+    }
+    else
+    {
+        stats.avgLatencyUs = stats.avgLatencyUs - (stats.avgLatencyUs >> 3) + (latency >> 3);
+    }
+}
+
+const InputStats *input_getStats(void)
+{
+    return &stats;
+}
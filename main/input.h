@@ -0,0 +1,77 @@
+/**
+ * @file input.h
+ * @brief Touch Input Pipeline - Event Queue and Gesture Recognition
+ *
+ * The sampler turns XPT2046 readings into timestamped down/move/up samples
+ * in a ring buffer. The recognizer turns those into tap, long-press, drag
+ * and fling events that the UI engine routes to the active screen.
+ */
+
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "ui_types.h"
+
+// ===================================
+// Input Statistics
+// ===================================
+typedef struct
+{
+    uint32_t samples;       // Raw samples queued
+    uint32_t dropped;       // Raw samples lost to a full queue
+    uint32_t events;        // Gestures dispatched
+    uint32_t lastLatencyUs; // Sample-to-handler-done for the last event
+    uint32_t maxLatencyUs;
+    uint32_t avgLatencyUs;  // Running average (1/8 weight)
+} InputStats;
+
+// ===================================
+// Input Pipeline Functions
+// ===================================
+
+/**
+ * @brief Reset queues, recognizer state and statistics
+ */
+void input_init(void);
+
+/**
+ * @brief Sample the touch controller and queue any contact transition
+ *
+ * Cheap enough to call between drawing steps so no contact is missed.
+ */
+void input_poll(void);
+
+/**
+ * @brief Check for queued samples or gestures not yet dispatched
+ * @return true if input is waiting to be processed
+ */
+bool input_pending(void);
+
+/**
+ * @brief Check whether a contact is currently down (release not yet seen)
+ * @return true while touching
+ */
+bool input_isTouching(void);
+
+/**
+ * @brief Get the next recognized gesture
+ * @param ev Event to fill
+ * @return true if an event was returned
+ */
+bool input_nextEvent(UIEvent *ev);
+
+/**
+ * @brief Record touch-to-response latency once an event has been handled
+ * @param ev The event that was just dispatched
+ */
+void input_recordLatency(const UIEvent *ev);
+
+/**
+ * @brief Get input pipeline statistics
+ * @return Pointer to the statistics structure
+ */
+const InputStats *input_getStats(void);
+
+#endif // INPUT_H
@@ -23,14 +23,23 @@
 #include "screens.h"
 #include "file_browser.h"
 #include "a9g_gps.h"
+#include "at_engine.h"
+#include "uart_rx.h"
+#include "track_log.h"
+#include "input.h"
+#include "scheduler.h"
+#include "perf.h"
+#include "memstats.h"
+#include "console.h"
+#include "screenshot.h"
+#include "workqueue.h"
+#include "power.h"
+#include "watchdog.h"
 
 // ===================================
 // Application Configuration
 // ===================================
 
-// Sensor update interval in milliseconds
-#define APP_SENSOR_UPDATE_INTERVAL 2000
-
 // SD Card CS Pin - CHANGE THIS TO YOUR ACTUAL SD CARD CS PIN
 #define SD_CS_PIN 10 // Common default, adjust if different
 
@@ -40,8 +49,18 @@
 FileBrowser sdBrowser;
 A9G_GPS gpsModule;
 
-static uint32_t lastSensorUpdate = 0;
-static uint32_t lastGPSUpdate = 0;
+// Background boot stages, run by taskBoot() after the first frame
+typedef enum
+{
+    BOOT_FIRST_FRAME = 0,
+    BOOT_SD_MOUNT,
+    BOOT_SD_SCAN,
+    BOOT_GPS,
+    BOOT_DONE
+} BootStage;
+
+static BootStage bootStage = BOOT_FIRST_FRAME;
+static int bootTask = -1;
 
 // ===================================
 // Sensor Simulation
@@ -58,11 +77,178 @@ void updateSensorValues(void)
     ui_updateValue(LABEL_POTASSIUM, random(35, 85));
 }
 
+// ===================================
+// Scheduler Tasks
+// ===================================
+
+void taskGPSPoll(void)
+{
+    PERF_SCOPE(PERF_ZONE_GPS_UPDATE);
+    gpsModule.update();
+}
+
+void taskGPSDisplay(void)
+{
+    static uint32_t seenFix = 0;
+    if (gpsModule.getSeq(GPS_SEQ_FIX) == seenFix)
+    {
+        return;
+    }
+    seenFix = gpsModule.getSeq(GPS_SEQ_FIX);
+
+    const GPSData *gpsData = gpsModule.getGPSData();
+    ui_setGPS(gpsData->valid);
+    ui_setGPSCoordinates(gpsData->latE7, gpsData->lonE7, gpsData->valid);
+}
+
+void taskStats(void)
+{
+    sched_printStats();
+    work_printStats();
+    at_printStats();
+    uart_printStats();
+    track_printStats();
+    gpsModule.printPowerStats();
+    power_report();
+    mem_report();
+}
+
+// ===================================
+// Console Commands
+// ===================================
+
+void cmdShot(const char *args)
+{
+    if (!shot_start())
+    {
+        SerialUSB.println(F("Screenshot already in progress"));
+    }
+}
+
+void cmdStats(const char *args)
+{
+    taskStats();
+}
+
+// Average cycles per call of the coordinate conversions, float versions
+// (software floating point here) against the int32 1e-7 degree ones
+static uint32_t benchCycles(uint32_t startUs, uint16_t runs)
+{
+    return (micros() - startUs) * (F_CPU / 1000000UL) / runs;
+}
+
+void cmdGeoBench(const char *args)
+{
+    const uint16_t runs = 500;
+    volatile int32_t minE5 = 3683400; // "2836.83400"
+    volatile float sinkF = 0;
+    volatile int32_t sinkI = 0;
+    char text[24];
+    char line[64];
+    uint32_t t;
+
+    t = micros();
+    for (uint16_t i = 0; i < runs; i++)
+    {
+        sinkF = 28.0f + (float)minE5 / 6000000.0f;
+    }
+    uint32_t nmeaF = benchCycles(t, runs);
+    t = micros();
+    for (uint16_t i = 0; i < runs; i++)
+    {
+        sinkI = 28 * GEO_E7 + (minE5 * 10 + 3) / 6;
+    }
+    uint32_t nmeaI = benchCycles(t, runs);
+
+    t = micros();
+    for (uint16_t i = 0; i < runs; i++)
+    {
+        sinkF = (float)strtod("77.209000", NULL);
+    }
+    uint32_t parseF = benchCycles(t, runs);
+    t = micros();
+    for (uint16_t i = 0; i < runs; i++)
+    {
+        sinkI = geo_parseE7("77.209000", NULL);
+    }
+    uint32_t parseI = benchCycles(t, runs);
+
+    t = micros();
+    for (uint16_t i = 0; i < runs; i++)
+    {
+        snprintf(text, sizeof(text), "%.6f", sinkF);
+    }
+    uint32_t fmtF = benchCycles(t, runs);
+    t = micros();
+    for (uint16_t i = 0; i < runs; i++)
+    {
+        geo_formatE7(text, sizeof(text), sinkI, 6);
+    }
+    uint32_t fmtI = benchCycles(t, runs);
+
+    snprintf(line, sizeof(line), "nmea->deg  float %5lu  int %5lu cycles",
+             (unsigned long)nmeaF, (unsigned long)nmeaI);
+    SerialUSB.println(line);
+    snprintf(line, sizeof(line), "parse deg  float %5lu  int %5lu cycles",
+             (unsigned long)parseF, (unsigned long)parseI);
+    SerialUSB.println(line);
+    snprintf(line, sizeof(line), "format 6dp float %5lu  int %5lu cycles",
+             (unsigned long)fmtF, (unsigned long)fmtI);
+    SerialUSB.println(line);
+}
+
+// "track" prints the log counters; "track <from> <to>" lists the points
+// between two times in seconds since 2000-01-01 UTC
+void cmdTrack(const char *args)
+{
+    char *end;
+    uint32_t from = strtoul(args, &end, 10);
+    if (end == args)
+    {
+        track_printStats();
+        return;
+    }
+    uint32_t until = strtoul(end, NULL, 10);
+
+    TrackReader reader;
+    if (!track_openRange(&reader, from, until))
+    {
+        SerialUSB.println(F("No track log"));
+        return;
+    }
+    TrackPoint p;
+    uint32_t n = 0;
+    char line[48];
+    while (track_next(&reader, &p))
+    {
+        int len = snprintf(line, sizeof(line), "%lu,", (unsigned long)p.time);
+        len += geo_formatE7(line + len, sizeof(line) - len, p.latE7, 6);
+        line[len++] = ',';
+        len += geo_formatE7(line + len, sizeof(line) - len, p.lonE7, 6);
+        snprintf(line + len, sizeof(line) - len, ",%d", p.altM);
+        SerialUSB.println(line);
+        n++;
+    }
+    track_close(&reader);
+    SerialUSB.print(F("Track points: "));
+    SerialUSB.println(n);
+}
+
+void initConsole(void)
+{
+    console_addCommand("shot", cmdShot, "Stream a screenshot (tools/screenshot.py)");
+    console_addCommand("stats", cmdStats, "Print scheduler and memory statistics");
+    console_addCommand("geobench", cmdGeoBench, "Time float vs fixed-point coordinate code");
+    console_addCommand("track", cmdTrack, "Track log stats, or points in <from> <to> (s since 2000)");
+}
+
 // ===================================
 // SD Card Initialization with Debugging
 // ===================================
 
-void initSDCard()
+// Mounts the card and queues the root directory scan; returns false if
+// there is no usable card
+bool initSDCard()
 {
     SerialUSB.println(F("\n=== SD Card Initialization ==="));
     SerialUSB.print(F("SD CS Pin: "));
@@ -81,48 +267,126 @@ void initSDCard()
 
         // Show alert on screen
         ui_showAlert("SD Card Failed!", UI_ALERT_ERROR);
-        return;
+        return false;
     }
 
     SerialUSB.println(F("SUCCESS: SD Card initialized!"));
 
-    // Get file count
+    // Entries are counted (and listed) in work-queue slices
+    sdBrowser.scanRoot();
+    return true;
+}
+
+void sdScanComplete()
+{
     int fileCount = sdBrowser.getFileCount();
     SerialUSB.print(F("Files found: "));
     SerialUSB.println(fileCount);
 
-    // List all files
-    if (fileCount > 0)
+    if (fileCount == 0)
+    {
+        SerialUSB.println(F("WARNING: SD card is empty or root directory has no files"));
+    }
+
+    // A visible Files page was drawn from a partial count
+    if (ui_getCurrentScreen() == SCREEN_FILES)
+    {
+        ui_requestRedraw();
+    }
+
+    SerialUSB.println(F("=== SD Card Initialization Complete ===\n"));
+}
+
+// ===================================
+// Staged Boot
+// ===================================
+
+// The display, touch and scheduler are up before loop() starts. The SD card
+// and A9G come up here one step per run, with progress in the header; the
+// A9G power-up itself is stepped by its own update() in the "gps" task.
+void taskBoot(void)
+{
+    char status[BOOT_STATUS_LEN];
+
+    switch (bootStage)
     {
-        SerialUSB.println(F("\n--- Root Directory Contents ---"));
-        for (int i = 0; i < fileCount; i++)
+    case BOOT_FIRST_FRAME:
+        // SD.begin() blocks briefly, so let the first page finish first
+        if (ui_getState()->needsFullRedraw)
+        {
+            return;
+        }
+        SerialUSB.print(F("First frame at "));
+        SerialUSB.print(millis());
+        SerialUSB.println(F(" ms"));
+        ui_setBootStatus("SD mount");
+        bootStage = BOOT_SD_MOUNT;
+        return;
+
+    case BOOT_SD_MOUNT:
+        if (initSDCard())
+        {
+            wdt_logLastReset(); // wdt_begin() ran before the card was there
+            bootStage = BOOT_SD_SCAN;
+        }
+        else
+        {
+            bootStage = BOOT_GPS;
+        }
+        break;
+
+    case BOOT_SD_SCAN:
+        if (sdBrowser.isScanning())
         {
-            FileEntry *entry = sdBrowser.getFile(i);
-            if (entry)
-            {
-                SerialUSB.print(i);
-                SerialUSB.print(F(": "));
-                SerialUSB.print(entry->name);
-                if (entry->isDirectory)
-                {
-                    SerialUSB.println(F(" [DIR]"));
-                }
-                else
-                {
-                    SerialUSB.print(F(" ("));
-                    SerialUSB.print(entry->size);
-                    SerialUSB.println(F(" bytes)"));
-                }
-            }
+            snprintf(status, sizeof(status), "SD scan %d", sdBrowser.getFileCount());
+            ui_setBootStatus(status);
+            return;
         }
-        SerialUSB.println(F("-------------------------------\n"));
+        sdScanComplete();
+        bootStage = BOOT_GPS;
+        break;
+
+    case BOOT_GPS:
+        if (gpsModule.isBooting())
+        {
+            ui_setBootStatus(gpsModule.getBootStage());
+            return;
+        }
+        bootStage = BOOT_DONE;
+        break;
+
+    default:
+        break;
     }
-    else
+
+    if (bootStage == BOOT_DONE)
     {
-        SerialUSB.println(F("WARNING: SD card is empty or root directory has no files"));
+        ui_setBootStatus(NULL);
+        sched_setEnabled(bootTask, false);
+        SerialUSB.print(F("=== System Ready ("));
+        SerialUSB.print(millis());
+        SerialUSB.println(F(" ms) ===\n"));
     }
+}
 
-    SerialUSB.println(F("=== SD Card Initialization Complete ===\n"));
+void initTasks(void)
+{
+    // UI gets the highest priority; background tasks only start when their
+    // budget fits before the next frame or touch sample is due
+    sched_addTask("ui", ui_update, UI_FRAME_MS * 1000UL, 12000, TASK_PRIO_UI);
+    sched_addTask("touch", input_poll, TOUCH_SAMPLE_MS * 1000UL, 300, TASK_PRIO_UI);
+    bootTask = sched_addTask("boot", taskBoot, BOOT_POLL_MS * 1000UL, 1000, TASK_PRIO_NORMAL);
+    sched_addTask("gps", taskGPSPoll, GPS_POLL_MS * 1000UL, 2000, TASK_PRIO_NORMAL);
+    sched_addTask("sensors", updateSensorValues, SENSOR_UPDATE_MS * 1000UL, 500, TASK_PRIO_NORMAL);
+    sched_addTask("gps-ui", taskGPSDisplay, GPS_UI_REFRESH_MS * 1000UL, 1000, TASK_PRIO_LOW);
+    sched_addTask("console", console_poll, CONSOLE_POLL_MS * 1000UL, 500, TASK_PRIO_LOW);
+    sched_addTask("shot", shot_poll, SHOT_BAND_MS * 1000UL, 3000, TASK_PRIO_LOW);
+#if SCHED_STATS_MS > 0
+    sched_addTask("stats", taskStats, SCHED_STATS_MS * 1000UL, 5000, TASK_PRIO_LOW);
+#endif
+#if PERF_ENABLED
+    sched_addTask("perf", perf_report, PERF_REPORT_MS * 1000UL, 3000, TASK_PRIO_LOW);
+#endif
 }
 
 // ===================================
@@ -132,8 +396,9 @@ void initSDCard()
 void setup()
 {
     // Initialize serial for debugging
+    // No wait for the serial monitor: boot output before it attaches is lost,
+    // "stats" over the console reports the state at any time
     SerialUSB.begin(115200);
-    delay(2000); // Wait for serial monitor
     SerialUSB.println(F("\n=== FarmBot UI Engine v3.0 ==="));
 
     // Initialize bare-metal hardware SPI (SERCOM1)
@@ -161,21 +426,18 @@ void setup()
     ui_setGSM(80);
     ui_setGPS(false); // Will be updated by GPS module
 
-    // Initialize SD Card with debugging
-    initSDCard();
-
-    // Initialize A9G GPS Module
+    // Start the A9G power-up; the "gps" task finishes it in the background
+    // and the SD card is mounted by taskBoot() after the first frame
     SerialUSB.println(F("Initializing A9G GPS..."));
-    if (gpsModule.begin())
-    {
-        SerialUSB.println(F("GPS module initialized!"));
-    }
-    else
-    {
-        SerialUSB.println(F("GPS module failed to initialize"));
-    }
+    gpsModule.begin();
+
+    initConsole();
+    initTasks();
+    wdt_begin();
 
-    SerialUSB.println(F("=== System Ready ===\n"));
+    SerialUSB.print(F("=== UI Ready ("));
+    SerialUSB.print(millis());
+    SerialUSB.println(F(" ms), SD and GPS starting in background ===\n"));
 }
 
 // ===================================
@@ -184,28 +446,19 @@ void setup()
 
 void loop()
 {
-    // Main UI update (handles touch, screen drawing, etc.)
-    ui_update();
+    wdt_feed();
 
-    // Update sensor values periodically
-    if (millis() - lastSensorUpdate > APP_SENSOR_UPDATE_INTERVAL)
+    // Every periodic job (touch, UI frames, GPS, sensors) is a scheduler task;
+    // background work gets the gaps, and with none queued the CPU sleeps
+    if (!sched_run())
     {
-        lastSensorUpdate = millis();
-        updateSensorValues();
-    }
-
-    // Update GPS data
-    gpsModule.update();
-
-    // Update GPS display every 3 seconds
-    if (millis() - lastGPSUpdate > 3000)
-    {
-        lastGPSUpdate = millis();
-        GPSData gpsData = gpsModule.getGPSData();
-        ui_setGPS(gpsData.valid);
-        ui_setGPSCoordinates(gpsData.latitude, gpsData.longitude, gpsData.valid);
+        if (work_pending())
+        {
+            work_idle(sched_slackUs());
+        }
+        else
+        {
+            power_idle(sched_slackUs());
+        }
     }
-
-    // Small delay to prevent CPU hogging
-    delay(1);
-}
\ No newline at end of file
+}
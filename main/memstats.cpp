@@ -0,0 +1,65 @@
+/**
+ * @file memstats.cpp
+ * @brief Heap Usage and Allocation Counters Implementation
+ */
+
+#include "memstats.h"
+
+static uint32_t reportedCalls = 0;
+
+#if defined(ARDUINO_ARCH_SAMD)
+
+#include <malloc.h>
+#include <sys/reent.h>
+
+extern "C" char *sbrk(int incr);
+
+static volatile uint32_t allocCalls = 0;
+
+// newlib brackets every malloc/free/realloc with these hooks. Nothing here
+// runs allocations from interrupts, so counting is all they need to do.
+extern "C" void __malloc_lock(struct _reent *r)
+{
+    (void)r;
+    allocCalls++;
+}
+
+extern "C" void __malloc_unlock(struct _reent *r)
+{
+    (void)r;
+}
+
+void mem_getStats(MemStats *stats)
+{
+    struct mallinfo info = mallinfo();
+    char stackTop;
+
+    stats->heapUsed = info.uordblks;
+    stats->heapHighWater = info.arena;
+    stats->allocCalls = allocCalls;
+    stats->stackGap = (uint32_t)(&stackTop - sbrk(0));
+}
+
+#else
+
+void mem_getStats(MemStats *stats)
+{
+    memset(stats, 0, sizeof(MemStats));
+}
+
+#endif
+
+void mem_report(void)
+{
+    MemStats stats;
+    mem_getStats(&stats);
+
+    // mallinfo() itself goes through the allocator lock once
+    char line[96];
+    snprintf(line, sizeof(line), "heap used=%lu high=%lu stack-gap=%lu allocs=%lu (+%lu)",
+             (unsigned long)stats.heapUsed, (unsigned long)stats.heapHighWater,
+             (unsigned long)stats.stackGap, (unsigned long)stats.allocCalls,
+             (unsigned long)(stats.allocCalls - reportedCalls));
+    SerialUSB.println(line);
+    reportedCalls = stats.allocCalls;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file memstats.h
+ * @brief Heap Usage and Allocation Counters
+ *
+ * Counts every entry into the newlib allocator and tracks the heap
+ * high-water mark, so steady-state code paths can be shown to allocate
+ * nothing. Only available on the SAMD build; elsewhere all values read 0.
+ */
+
+#ifndef MEMSTATS_H
+#define MEMSTATS_H
+
+#include <Arduino.h>
+
+// ===================================
+// Memory Statistics
+// ===================================
+typedef struct
+{
+    uint32_t heapUsed;      // Bytes currently allocated
+    uint32_t heapHighWater; // Heap obtained from sbrk (never shrinks)
+    uint32_t allocCalls;    // malloc/free/realloc entries since boot
+    uint32_t stackGap;      // Free bytes between heap top and stack
+} MemStats;
+
+// ===================================
+// Memory Functions
+// ===================================
+
+/**
+ * @brief Take a snapshot of heap usage
+ * @param stats Structure to fill
+ */
+void mem_getStats(MemStats *stats);
+
+/**
+ * @brief Print heap usage and allocator calls since the last report
+ */
+void mem_report(void);
+
+#endif // MEMSTATS_H
@@ -0,0 +1,336 @@
+/**
+ * @file nmea.cpp
+ * @brief Streaming NMEA 0183 Parser Implementation
+ */
+
+#include "nmea.h"
+
+enum
+{
+    NMEA_WAIT = 0, // Looking for '$'
+    NMEA_BODY,
+    NMEA_CHECKSUM
+};
+
+// ===================================
+// Field Decoding
+// ===================================
+
+// Decimal field as an integer scaled by 10^decimals ("12.3", 2 -> 1230);
+// extra decimals are truncated
+static int32_t nmea_fixed(const char *s, uint8_t decimals)
+{
+    bool neg = (*s == '-');
+    if (neg)
+    {
+        s++;
+    }
+    int32_t v = 0;
+    int8_t frac = -1;
+    for (; *s != '\0'; s++)
+    {
+        if (*s == '.')
+        {
+            frac = 0;
+            continue;
+        }
+        if (*s < '0' || *s > '9')
+        {
+            break;
+        }
+        if (frac >= (int8_t)decimals)
+        {
+            continue;
+        }
+        v = v * 10 + (*s - '0');
+        if (frac >= 0)
+        {
+            frac++;
+        }
+    }
+    for (int8_t i = (frac < 0) ? 0 : frac; i < (int8_t)decimals; i++)
+    {
+        v *= 10;
+    }
+    return neg ? -v : v;
+}
+
+// "ddmm.mmmmm" / "dddmm.mmmmm" to degrees x 1e7: 1e-5 minute is 1/6 of
+// 1e-6 degree, so the minutes convert with one multiply and divide
+static int32_t nmea_coordinate(const char *s)
+{
+    int32_t v = nmea_fixed(s, 5);
+    int32_t deg = v / 10000000L;
+    int32_t minE5 = v % 10000000L;
+    return deg * GEO_E7 + (minE5 * 10 + 3) / 6;
+}
+
+static NmeaType nmea_type(const char *id, uint8_t len)
+{
+    // Talker ID (2 letters) then the sentence formatter
+    if (len != 5)
+    {
+        return NMEA_NONE;
+    }
+    const char *f = id + 2;
+    if (f[0] == 'G' && f[1] == 'G' && f[2] == 'A')
+        return NMEA_GGA;
+    if (f[0] == 'R' && f[1] == 'M' && f[2] == 'C')
+        return NMEA_RMC;
+    if (f[0] == 'G' && f[1] == 'S' && f[2] == 'A')
+        return NMEA_GSA;
+    if (f[0] == 'G' && f[1] == 'S' && f[2] == 'V')
+        return NMEA_GSV;
+    if (f[0] == 'V' && f[1] == 'T' && f[2] == 'G')
+        return NMEA_VTG;
+    return NMEA_NONE;
+}
+
+static void nmea_setTime(GPSData *g, const char *s)
+{
+    g->utcTime = (uint32_t)nmea_fixed(s, 0);
+    snprintf(g->lastUpdate, sizeof(g->lastUpdate), "%02lu:%02lu:%02lu UTC",
+             (unsigned long)(g->utcTime / 10000), (unsigned long)(g->utcTime / 100 % 100),
+             (unsigned long)(g->utcTime % 100));
+}
+
+// Hemisphere letters follow their coordinate; south and west are stored
+// negative, as AT+LOCATION reports them
+static void nmea_setLat(GPSData *g, char dir)
+{
+    g->latDirection = dir;
+    if ((dir == 'S') == (g->latE7 > 0))
+    {
+        g->latE7 = -g->latE7;
+    }
+}
+
+static void nmea_setLon(GPSData *g, char dir)
+{
+    g->lonDirection = dir;
+    if ((dir == 'W') == (g->lonE7 > 0))
+    {
+        g->lonE7 = -g->lonE7;
+    }
+}
+
+// Apply one complete field to the pending fix. Empty fields leave the
+// previous value, except where they mean "no fix".
+static void nmea_field(NmeaParser *p)
+{
+    GPSData *g = &p->pending;
+    const char *s = p->buf;
+    bool empty = (p->len == 0);
+
+    switch (p->type)
+    {
+    case NMEA_GGA:
+        switch (p->field)
+        {
+        case 1: if (!empty) nmea_setTime(g, s); break;
+        case 2: if (!empty) g->latE7 = nmea_coordinate(s); break;
+        case 3: if (!empty) nmea_setLat(g, s[0]); break;
+        case 4: if (!empty) g->lonE7 = nmea_coordinate(s); break;
+        case 5: if (!empty) nmea_setLon(g, s[0]); break;
+        case 6:
+            g->fixQuality = empty ? 0 : (uint8_t)nmea_fixed(s, 0);
+            g->valid = (g->fixQuality > 0);
+            break;
+        case 7: g->satellites = empty ? 0 : (uint8_t)nmea_fixed(s, 0); break;
+        case 8: if (!empty) g->hdop = nmea_fixed(s, 2) / 100.0f; break;
+        case 9: if (!empty) g->altitude = nmea_fixed(s, 1) / 10.0f; break;
+        }
+        break;
+
+    case NMEA_RMC:
+        switch (p->field)
+        {
+        case 1: if (!empty) nmea_setTime(g, s); break;
+        case 2: g->valid = (s[0] == 'A'); break;
+        case 3: if (!empty) g->latE7 = nmea_coordinate(s); break;
+        case 4: if (!empty) nmea_setLat(g, s[0]); break;
+        case 5: if (!empty) g->lonE7 = nmea_coordinate(s); break;
+        case 6: if (!empty) nmea_setLon(g, s[0]); break;
+        case 7: if (!empty) g->speedKmh = nmea_fixed(s, 2) * 1.852f / 100.0f; break;
+        case 8: if (!empty) g->course = nmea_fixed(s, 2) / 100.0f; break;
+        case 9: if (!empty) g->utcDate = (uint32_t)nmea_fixed(s, 0); break;
+        }
+        break;
+
+    case NMEA_GSA:
+        if (p->field == 2)
+        {
+            g->fixType = empty ? 1 : (uint8_t)nmea_fixed(s, 0);
+        }
+        else if (p->field == 16 && !empty)
+        {
+            g->hdop = nmea_fixed(s, 2) / 100.0f;
+        }
+        break;
+
+    case NMEA_GSV:
+        if (p->field == 3 && !empty)
+        {
+            g->satsInView = (uint8_t)nmea_fixed(s, 0);
+        }
+        break;
+
+    case NMEA_VTG:
+        if (p->field == 1 && !empty)
+        {
+            g->course = nmea_fixed(s, 2) / 100.0f;
+        }
+        else if (p->field == 7 && !empty)
+        {
+            g->speedKmh = nmea_fixed(s, 2) / 100.0f;
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+// Field 0 names the sentence; later fields are decoded as they complete
+static void nmea_endField(NmeaParser *p)
+{
+    p->buf[p->len] = '\0';
+    if (p->field == 0)
+    {
+        p->type = nmea_type(p->buf, p->len);
+        if (p->type == NMEA_NONE)
+        {
+            p->ignored++;
+            p->state = NMEA_WAIT; // Skip the rest of the sentence
+        }
+    }
+    else
+    {
+        nmea_field(p);
+    }
+    p->len = 0;
+}
+
+static int8_t nmea_hex(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    return -1;
+}
+
+// Days since 2000-01-01; the year is taken to start in March so the leap
+// day falls at its end
+static uint32_t nmea_days(uint16_t y, uint8_t m, uint8_t d)
+{
+    if (m <= 2)
+    {
+        y--;
+        m += 12;
+    }
+    return 365UL * y + y / 4 - y / 100 + y / 400 + (153 * (m - 3) + 2) / 5 + d - 1 - 730425UL;
+}
+
+// ===================================
+// Public API
+// ===================================
+
+void nmea_init(NmeaParser *p)
+{
+    memset(p, 0, sizeof(NmeaParser));
+}
+
+NmeaType nmea_feed(NmeaParser *p, char c, GPSData *fix)
+{
+    if (c == '$')
+    {
+        p->state = NMEA_BODY;
+        p->type = NMEA_NONE;
+        p->field = 0;
+        p->len = 0;
+        p->sum = 0;
+        p->pending = *fix;
+        return NMEA_NONE;
+    }
+
+    switch (p->state)
+    {
+    case NMEA_BODY:
+        if (c == '*')
+        {
+            nmea_endField(p);
+            if (p->state == NMEA_BODY)
+            {
+                p->state = NMEA_CHECKSUM;
+                p->sumRx = 0;
+                p->sumDigits = 0;
+            }
+        }
+        else if (c == ',')
+        {
+            p->sum ^= (uint8_t)c;
+            nmea_endField(p);
+            p->field++;
+        }
+        else if (c == '\r' || c == '\n')
+        {
+            p->malformed++; // No checksum: not trusted
+            p->state = NMEA_WAIT;
+        }
+        else if (p->len < NMEA_FIELD_LEN - 1)
+        {
+            p->sum ^= (uint8_t)c;
+            p->buf[p->len++] = c;
+        }
+        else
+        {
+            p->malformed++;
+            p->state = NMEA_WAIT;
+        }
+        break;
+
+    case NMEA_CHECKSUM:
+    {
+        int8_t digit = nmea_hex(c);
+        if (digit >= 0 && p->sumDigits < 2)
+        {
+            p->sumRx = (uint8_t)((p->sumRx << 4) | digit);
+            p->sumDigits++;
+            break;
+        }
+        p->state = NMEA_WAIT;
+        if ((c != '\r' && c != '\n') || p->sumDigits != 2)
+        {
+            p->malformed++;
+            break;
+        }
+        if (p->sumRx != p->sum)
+        {
+            p->checksumErrors++;
+            break;
+        }
+        *fix = p->pending;
+        p->sentences++;
+        return p->type;
+    }
+
+    default:
+        break;
+    }
+    return NMEA_NONE;
+}
+
+uint32_t nmea_seconds(const GPSData *fix)
+{
+    uint32_t date = fix->utcDate;
+    if (date == 0)
+    {
+        return 0;
+    }
+    uint32_t days = nmea_days(2000 + date % 100, date / 100 % 100, date / 10000);
+    uint32_t t = fix->utcTime;
+    return days * 86400UL + t / 10000 * 3600 + t / 100 % 100 * 60 + t % 100;
+}
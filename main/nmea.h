@@ -0,0 +1,102 @@
+/**
+ * @file nmea.h
+ * @brief Streaming NMEA 0183 Parser
+ *
+ * Fed one byte at a time. Each field is decoded as soon as its comma
+ * arrives, with integer arithmetic, into a pending copy of the fix; the
+ * copy only replaces the caller's GPSData once the sentence's checksum
+ * verifies. No heap, no sentence buffer: the parser state is one field
+ * plus the pending fix.
+ *
+ * Understood: GGA, RMC, GSA, GSV and VTG from any talker (GP, GN, GL...).
+ */
+
+#ifndef NMEA_H
+#define NMEA_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "geo.h"
+
+// ===================================
+// GPS Data Structure
+// ===================================
+typedef struct
+{
+    bool valid;
+    int32_t latE7;       // Degrees x 1e7, south negative (geo.h)
+    int32_t lonE7;       // Degrees x 1e7, west negative
+    float altitude;      // Metres above mean sea level (GGA)
+    uint8_t satellites;  // Used in the fix (GGA)
+    char latDirection;   // 'N' or 'S'
+    char lonDirection;   // 'E' or 'W'
+    char lastUpdate[20]; // Time string
+    uint8_t fixQuality;  // GGA: 0 none, 1 GPS, 2 DGPS
+    uint8_t fixType;     // GSA: 1 none, 2 2D, 3 3D
+    uint8_t satsInView;  // GSV
+    float hdop;
+    float speedKmh;      // RMC / VTG
+    float course;        // Degrees true
+    uint32_t utcTime;    // hhmmss
+    uint32_t utcDate;    // ddmmyy (0 until an RMC arrives)
+} GPSData;
+
+// ===================================
+// Parser State
+// ===================================
+typedef enum
+{
+    NMEA_NONE = 0,
+    NMEA_GGA,
+    NMEA_RMC,
+    NMEA_GSA,
+    NMEA_GSV,
+    NMEA_VTG
+} NmeaType;
+
+typedef struct
+{
+    uint8_t state;
+    NmeaType type;
+    uint8_t field;                // Index of the field being read
+    char buf[NMEA_FIELD_LEN];
+    uint8_t len;
+    uint8_t sum;                  // XOR of the characters after '$'
+    uint8_t sumRx;                // Checksum as received
+    uint8_t sumDigits;
+    GPSData pending;              // Fix as it will be if the checksum holds
+
+    // Statistics
+    uint32_t sentences;           // Verified and applied
+    uint32_t checksumErrors;
+    uint32_t malformed;           // Missing checksum or overlong field
+    uint32_t ignored;             // Sentence types not understood
+} NmeaParser;
+
+// ===================================
+// NMEA Functions
+// ===================================
+
+/**
+ * @brief Reset a parser and its statistics
+ * @param p Parser
+ */
+void nmea_init(NmeaParser *p);
+
+/**
+ * @brief Feed one received character
+ * @param p Parser
+ * @param c Character (a '$' always restarts, '\n' ends a sentence)
+ * @param fix Updated when a sentence verifies
+ * @return Type of the sentence just applied to fix, else NMEA_NONE
+ */
+NmeaType nmea_feed(NmeaParser *p, char c, GPSData *fix);
+
+/**
+ * @brief UTC time of a fix as seconds since 2000-01-01 00:00:00
+ * @param fix Fix with utcDate and utcTime
+ * @return Seconds, or 0 before an RMC sentence has supplied the date
+ */
+uint32_t nmea_seconds(const GPSData *fix);
+
+#endif // NMEA_H
@@ -3,16 +3,48 @@
 #include "../../drawing.h"
 #include "../../file_browser.h"
 #include "../../simple_font.h"
+#include "../../tft_driver.h"
+#include "../../perf.h"
 #include <stdio.h>
 #include <string.h>
 
 // External reference to global SD browser
 extern FileBrowser sdBrowser;
 
-// Internal state for this page
-static int lastTouchY = -1;
-static int touchStartY = -1;
-static bool firstFileDraw = true;
+// List geometry: the list is the panel's hardware scroll area, with the
+// header + path bar fixed above it and the navbar fixed below it
+#define LIST_TOP (CONTENT_Y + 35)
+#define LIST_HEIGHT (NAVBAR_Y - LIST_TOP)
+#define ROW_PITCH 50
+#define ITEM_HEIGHT 45
+#define SCROLLBAR_X (SCREEN_WIDTH - 10)
+#define SCROLLBAR_W 8
+
+// Directory entries cached in the page arena while Files is visible
+#define WINDOW_ENTRIES 96
+
+// Kinetic scrolling tuning
+#define FLING_TAU_MS 325      // Velocity decays by 1/e every tau
+#define FLING_STOP_VELOCITY 40 // px/s below which the list snaps to a row
+#define FRAME_MAX_US 50000UL  // Cap on the physics step after a stall
+
+typedef enum {
+    MOTION_IDLE = 0,
+    MOTION_DRAGGING,
+    MOTION_FLINGING,
+    MOTION_SNAPPING
+} ListMotion;
+
+// Page state, held in the page arena only while Files is visible
+typedef struct {
+    int32_t scrollQ;      // Scroll position in 1/16 px
+    int32_t shownPx;      // Scroll position currently on the panel
+    int32_t velocity;     // px/s, positive scrolls towards later rows
+    ListMotion motion;
+    uint32_t lastFrameUs;
+} FilesState;
+
+static FilesState *st = NULL;
 
 // --- Helper Functions (Static to avoid linking errors) ---
 
@@ -79,200 +111,359 @@ static void drawTruncatedText(int16_t x, int16_t y, const char* text, int16_t ma
     }
 }
 
-// --- Page Implementation ---
+// --- List Geometry ---
 
-void screen_files_draw(void)
-{
-    static int lastScrollOffset = -1;
-    static int lastFileCount = -1;
-    static int lastSelectedIndex = -1;
-    bool fullRedraw = false;
-    
-    if (firstFileDraw) {
-        SerialUSB.println(F("\n=== Files Screen Draw ==="));
-        fullRedraw = true;
-        firstFileDraw = false;
-    }
-    
-    const int16_t itemHeight = 45;
+static int rowCount(void) {
+    return sdBrowser.getFileCount() + (sdBrowser.canGoUp() ? 1 : 0);
+}
+
+static int32_t maxScrollPx(void) {
+    int32_t contentH = (int32_t)rowCount() * ROW_PITCH;
+    return (contentH > LIST_HEIGHT) ? contentH - LIST_HEIGHT : 0;
+}
+
+// Display RAM line holding list content line cy (the list is a ring)
+static int16_t ramLine(int32_t cy) {
+    return LIST_TOP + (int16_t)(cy % LIST_HEIGHT);
+}
+
+// Fill a rectangle given in list content coordinates, split at the ring wrap
+static void fillContent(int16_t x, int32_t cy, int16_t w, int16_t h, uint16_t color) {
+    int16_t first = LIST_HEIGHT - (int16_t)(cy % LIST_HEIGHT);
+    if (first > h) first = h;
+    draw_fillRect(x, ramLine(cy), w, first, color);
+    if (h > first) draw_fillRect(x, LIST_TOP, w, h - first, color);
+}
+
+// --- Row Rendering ---
+
+static void drawRow(int row, int16_t yPos) {
     const int16_t margin = 5;
-    const int16_t itemWidth = SCREEN_WIDTH - (margin * 2);
+    const int16_t itemWidth = SCROLLBAR_X - margin * 2;
     const int16_t iconSize = 30;
     
-    int currentScrollOffset = sdBrowser.getScrollOffset();
-    int currentFileCount = sdBrowser.getFileCount();
-    int currentSelectedIndex = sdBrowser.getSelectedIndex();
-    
-    bool scrollChanged = (currentScrollOffset != lastScrollOffset);
-    bool fileCountChanged = (currentFileCount != lastFileCount);
-    bool selectionChanged = (currentSelectedIndex != lastSelectedIndex);
-    
-    if (fullRedraw || fileCountChanged) {
-        SerialUSB.println(F("Full redraw"));
-        draw_fillRect(0, CONTENT_Y, SCREEN_WIDTH, CONTENT_HEIGHT, COLOR_WHITE);
-        draw_fillRect(margin, CONTENT_Y + 5, itemWidth, 25, COLOR_BLUE);
-        draw_fillRect(margin + 2, CONTENT_Y + 7, itemWidth - 4, 21, COLOR_DARKGRAY);
-        SerialUSB.print(F("Current path: "));
-        SerialUSB.println(sdBrowser.getCurrentPath());
-        lastScrollOffset = -1; 
-        lastSelectedIndex = -1;
-    }
-    
-    int yPos = CONTENT_Y + 35;
-    
     if (sdBrowser.canGoUp()) {
-        if (fullRedraw || fileCountChanged) {
-            draw_fillRect(margin, yPos, itemWidth, itemHeight, COLOR_GRAY);
-            draw_rect(margin, yPos, itemWidth, itemHeight, COLOR_DARKGRAY);
+        if (row == 0) {
+            draw_fillRect(margin, yPos, itemWidth, ITEM_HEIGHT, COLOR_GRAY);
+            draw_rect(margin, yPos, itemWidth, ITEM_HEIGHT, COLOR_DARKGRAY);
             draw_fillRect(margin + 5, yPos + 7, iconSize, iconSize, COLOR_YELLOW);
             draw_fillRect(margin + 8, yPos + 10, iconSize - 6, iconSize - 6, COLOR_DARKGRAY);
             drawTruncatedText(margin + iconSize + 10, yPos + 15, "..", 120, COLOR_GRAY);
+            return;
         }
-        yPos += itemHeight + 5;
+        row--;
     }
     
-    int visibleItems = 4;
-    int totalFiles = currentFileCount;
+    FileEntry* entry = sdBrowser.getFile(row);
+    if (!entry) return;
+    
+    uint16_t bgColor = (row == sdBrowser.getSelectedIndex()) ? COLOR_CYAN : COLOR_LIGHTGRAY;
+    draw_fillRect(margin, yPos, itemWidth, ITEM_HEIGHT, bgColor);
+    draw_rect(margin, yPos, itemWidth, ITEM_HEIGHT, COLOR_DARKGRAY);
     
-    if (scrollChanged || selectionChanged || fullRedraw || fileCountChanged) {
-        SerialUSB.print(F("Redrawing items - Total files: "));
-        SerialUSB.print(totalFiles);
-        SerialUSB.print(F(", Scroll offset: "));
-        SerialUSB.print(currentScrollOffset);
-        SerialUSB.print(F(", Selected: "));
-        SerialUSB.println(currentSelectedIndex);
+    uint16_t iconColor = entry->isDirectory ? COLOR_YELLOW : COLOR_BLUE;
+    draw_fillRect(margin + 5, yPos + 7, iconSize, iconSize, iconColor);
+    
+    if (entry->isDirectory) {
+        draw_fillRect(margin + 5, yPos + 7, 15, 8, COLOR_ORANGE);
+    } else {
+        draw_hLine(margin + 10, yPos + 12, 20, COLOR_WHITE);
+        draw_hLine(margin + 10, yPos + 17, 20, COLOR_WHITE);
+        draw_hLine(margin + 10, yPos + 22, 20, COLOR_WHITE);
+        draw_hLine(margin + 10, yPos + 27, 20, COLOR_WHITE);
     }
     
-    if (totalFiles == 0) {
-        SerialUSB.println(F("WARNING: No files to display!"));
-        draw_fillRect(margin + 10, CONTENT_Y + 100, itemWidth - 20, 40, COLOR_RED);
-        draw_fillRect(margin + 12, CONTENT_Y + 102, itemWidth - 24, 36, COLOR_WHITE);
-        drawTruncatedText(margin + 30, CONTENT_Y + 115, "No Files Found", itemWidth - 60, COLOR_WHITE);
-        lastScrollOffset = currentScrollOffset;
-        lastFileCount = currentFileCount;
-        lastSelectedIndex = currentSelectedIndex;
-        return;
+    drawTruncatedText(margin + iconSize + 10, yPos + 15, entry->name, 110, bgColor);
+    
+    if (!entry->isDirectory) {
+        draw_fillRect(margin + itemWidth - 60, yPos + 10, 55, 25, COLOR_WHITE);
+        draw_rect(margin + itemWidth - 60, yPos + 10, 55, 25, COLOR_DARKGRAY);
+        char sizeStr[16];
+        if (entry->size < 1024) snprintf(sizeStr, sizeof(sizeStr), "%uB", (unsigned int)entry->size);
+        else if (entry->size < 1024 * 1024) snprintf(sizeStr, sizeof(sizeStr), "%uK", (unsigned int)(entry->size / 1024));
+        else snprintf(sizeStr, sizeof(sizeStr), "%uM", (unsigned int)(entry->size / (1024 * 1024)));
+        drawTruncatedText(margin + itemWidth - 55, yPos + 18, sizeStr, 50, COLOR_WHITE);
+    } else {
+        draw_fillRect(margin + itemWidth - 45, yPos + 15, 40, 15, COLOR_ORANGE);
+        drawTruncatedText(margin + itemWidth - 42, yPos + 18, "DIR", 35, COLOR_ORANGE);
     }
+}
+
+// Render list content lines [cy0, cy1) into display RAM. Only rows that
+// intersect the strip are touched, and drawing is clipped to the strip.
+static void renderStrip(int32_t cy0, int32_t cy1) {
+    const int16_t margin = 5;
+    int rows = rowCount();
     
-    if (scrollChanged || selectionChanged || fullRedraw || fileCountChanged) {
-        int itemsStartY = yPos;
-        int itemsEndY = yPos + (visibleItems * (itemHeight + 5));
+    while (cy0 < cy1) {
+        int32_t ringBase = (cy0 / LIST_HEIGHT) * LIST_HEIGHT;
+        int32_t segEnd = min(cy1, ringBase + LIST_HEIGHT);
+        int16_t shift = LIST_TOP - (int16_t)ringBase; // RAM line = cy + shift
+        int16_t segTop = (int16_t)(cy0 + shift);
+        int16_t segH = (int16_t)(segEnd - cy0);
+        
+        draw_setClip(0, segTop, SCROLLBAR_X, segH);
+        draw_fillRect(0, segTop, SCROLLBAR_X, segH, COLOR_WHITE);
         
-        if (!fullRedraw && !fileCountChanged) {
-            draw_fillRect(margin, itemsStartY, itemWidth, itemsEndY - itemsStartY, COLOR_WHITE);
+        for (int row = cy0 / ROW_PITCH; row < rows && (int32_t)row * ROW_PITCH < segEnd; row++) {
+            drawRow(row, (int16_t)((int32_t)row * ROW_PITCH + shift));
         }
         
-        for (int i = 0; i < visibleItems && (currentScrollOffset + i) < totalFiles; i++) {
-            FileEntry* entry = sdBrowser.getFile(currentScrollOffset + i);
-            if (!entry) break;
-            
-            uint16_t bgColor = (currentScrollOffset + i == currentSelectedIndex) ? COLOR_CYAN : COLOR_LIGHTGRAY;
-            draw_fillRect(margin, yPos, itemWidth, itemHeight, bgColor);
-            draw_rect(margin, yPos, itemWidth, itemHeight, COLOR_DARKGRAY);
-            
-            uint16_t iconColor = entry->isDirectory ? COLOR_YELLOW : COLOR_BLUE;
-            draw_fillRect(margin + 5, yPos + 7, iconSize, iconSize, iconColor);
-            
-            if (entry->isDirectory) {
-                draw_fillRect(margin + 5, yPos + 7, 15, 8, COLOR_ORANGE);
-            } else {
-                draw_hLine(margin + 10, yPos + 12, 20, COLOR_WHITE);
-                draw_hLine(margin + 10, yPos + 17, 20, COLOR_WHITE);
-                draw_hLine(margin + 10, yPos + 22, 20, COLOR_WHITE);
-                draw_hLine(margin + 10, yPos + 27, 20, COLOR_WHITE);
-            }
-            
-            drawTruncatedText(margin + iconSize + 10, yPos + 15, entry->name, 120, bgColor);
-            
-            if (!entry->isDirectory) {
-                draw_fillRect(margin + itemWidth - 60, yPos + 10, 55, 25, COLOR_WHITE);
-                draw_rect(margin + itemWidth - 60, yPos + 10, 55, 25, COLOR_DARKGRAY);
-                char sizeStr[16];
-                if (entry->size < 1024) snprintf(sizeStr, sizeof(sizeStr), "%uB", (unsigned int)entry->size);
-                else if (entry->size < 1024 * 1024) snprintf(sizeStr, sizeof(sizeStr), "%uK", (unsigned int)(entry->size / 1024));
-                else snprintf(sizeStr, sizeof(sizeStr), "%uM", (unsigned int)(entry->size / (1024 * 1024)));
-                drawTruncatedText(margin + itemWidth - 55, yPos + 18, sizeStr, 50, COLOR_WHITE);
-            } else {
-                draw_fillRect(margin + itemWidth - 45, yPos + 15, 40, 15, COLOR_ORANGE);
-                drawTruncatedText(margin + itemWidth - 42, yPos + 18, "DIR", 35, COLOR_ORANGE);
-            }
-            yPos += itemHeight + 5;
+        if (sdBrowser.getFileCount() == 0) {
+            int16_t boxY = (int16_t)(65 + shift);
+            draw_fillRect(margin + 10, boxY, SCROLLBAR_X - 40, 40, COLOR_RED);
+            draw_fillRect(margin + 12, boxY + 2, SCROLLBAR_X - 44, 36, COLOR_WHITE);
+            drawTruncatedText(margin + 30, boxY + 15, sdBrowser.isScanning() ? "Reading SD..." : "No Files Found",
+                              SCROLLBAR_X - 80, COLOR_WHITE);
         }
+        
+        cy0 = segEnd;
     }
+    draw_clearClip();
+}
+
+// The scrollbar column lives inside the scroll area, so it is repainted in
+// view space after every scroll step
+static void drawScrollbar(void) {
+    int32_t maxScroll = maxScrollPx();
+    if (maxScroll == 0) {
+        fillContent(SCROLLBAR_X, st->shownPx, SCREEN_WIDTH - SCROLLBAR_X, LIST_HEIGHT, COLOR_WHITE);
+        return;
+    }
+    
+    int32_t contentH = (int32_t)rowCount() * ROW_PITCH;
+    int16_t thumbH = max(20, (int16_t)((int32_t)LIST_HEIGHT * LIST_HEIGHT / contentH));
+    int16_t thumbY = (int16_t)(st->shownPx * (LIST_HEIGHT - thumbH) / maxScroll);
+    
+    fillContent(SCROLLBAR_X, st->shownPx, SCROLLBAR_W, thumbY, COLOR_LIGHTGRAY);
+    fillContent(SCROLLBAR_X, st->shownPx + thumbY, SCROLLBAR_W, thumbH, COLOR_BLUE);
+    fillContent(SCROLLBAR_X, st->shownPx + thumbY + thumbH, SCROLLBAR_W,
+                LIST_HEIGHT - thumbY - thumbH, COLOR_LIGHTGRAY);
+}
+
+// Move the panel to a new scroll position and render only the exposed strip
+static void applyScroll(int32_t newPx) {
+    int32_t oldPx = st->shownPx;
+    if (newPx == oldPx) return;
+    
+    st->shownPx = newPx;
+    tft_scrollTo(ramLine(newPx));
     
-    if (totalFiles > visibleItems) {
-        int totalScrollable = totalFiles - visibleItems;
-        // FIX: Removed std::max, just use max macro
-        int scrollBarHeight = max(20, (CONTENT_HEIGHT - 40) * visibleItems / totalFiles);
-        int scrollBarMaxY = CONTENT_HEIGHT - 40 - scrollBarHeight;
-        int scrollBarY = CONTENT_Y + 35 + (totalScrollable > 0 ? (currentScrollOffset * scrollBarMaxY) / totalScrollable : 0);
-        if (scrollChanged || fullRedraw || fileCountChanged) {
-            draw_fillRect(SCREEN_WIDTH - 10, CONTENT_Y + 35, 8, CONTENT_HEIGHT - 40, COLOR_LIGHTGRAY);
-            draw_fillRect(SCREEN_WIDTH - 10, scrollBarY, 8, scrollBarHeight, COLOR_BLUE);
+    int32_t delta = newPx - oldPx;
+    if (abs(delta) >= LIST_HEIGHT) {
+        renderStrip(newPx, newPx + LIST_HEIGHT);
+    } else if (delta > 0) {
+        renderStrip(oldPx + LIST_HEIGHT, newPx + LIST_HEIGHT);
+    } else {
+        renderStrip(newPx, oldPx);
+    }
+    drawScrollbar();
+}
+
+// Repaint one row if it is on screen (selection changes)
+static void redrawRow(int row) {
+    int32_t top = max((int32_t)row * ROW_PITCH, st->shownPx);
+    int32_t bottom = min((int32_t)row * ROW_PITCH + ROW_PITCH, st->shownPx + LIST_HEIGHT);
+    if (top < bottom) renderStrip(top, bottom);
+}
+
+static void setScroll(int32_t px) {
+    int32_t maxScroll = maxScrollPx();
+    if (px < 0) px = 0;
+    if (px > maxScroll) px = maxScroll;
+    st->scrollQ = px << 4;
+}
+
+static void resetList(void) {
+    st->scrollQ = 0;
+    st->shownPx = 0;
+    st->velocity = 0;
+    st->motion = MOTION_IDLE;
+}
+
+// --- Page Implementation ---
+
+static void files_enter(void)
+{
+    st = (FilesState *)ui_pageAlloc(sizeof(FilesState));
+    if (st == NULL) return; // ui_setScreen() goes back
+    st->motion = MOTION_IDLE;
+    st->lastFrameUs = micros();
+    
+    // Most of the arena goes to a directory window several screens tall
+    FileEntry* window = (FileEntry*)ui_pageAlloc(WINDOW_ENTRIES * sizeof(FileEntry));
+    if (window == NULL) return;
+    sdBrowser.attachWindow(window, WINDOW_ENTRIES);
+}
+
+// Slice 0 is the path bar and scroll setup, then one row pitch of the
+// visible list per slice, then the scrollbar
+static bool files_drawSlice(uint8_t slice)
+{
+    PERF_SCOPE(PERF_ZONE_FILES);
+    if (slice > 0) {
+        int32_t top = st->shownPx + (int32_t)(slice - 1) * ROW_PITCH;
+        int32_t bottom = st->shownPx + LIST_HEIGHT;
+        if (top < bottom) {
+            renderStrip(top, min(top + ROW_PITCH, bottom));
+            return true;
         }
+        drawScrollbar();
+        return false;
     }
+
+    SerialUSB.println(F("\n=== Files Screen Draw ==="));
+    SerialUSB.print(F("Current path: "));
+    SerialUSB.println(sdBrowser.getCurrentPath());
+    SerialUSB.print(F("Total files: "));
+    SerialUSB.println(sdBrowser.getFileCount());
+    
+    const int16_t margin = 5;
+    const int16_t itemWidth = SCREEN_WIDTH - (margin * 2);
+    
+    // Fixed part above the list
+    draw_fillRect(0, CONTENT_Y, SCREEN_WIDTH, LIST_TOP - CONTENT_Y, COLOR_WHITE);
+    draw_fillRect(margin, CONTENT_Y + 5, itemWidth, 25, COLOR_BLUE);
+    draw_fillRect(margin + 2, CONTENT_Y + 7, itemWidth - 4, 21, COLOR_DARKGRAY);
+    
+    // The list scrolls in hardware between the path bar and the navbar
+    tft_setScrollArea(LIST_TOP, SCREEN_HEIGHT - NAVBAR_Y);
+    setScroll(st->scrollQ >> 4);
+    st->shownPx = st->scrollQ >> 4;
+    tft_scrollTo(ramLine(st->shownPx));
+    return true;
+}
+
+static void files_update(void)
+{
+    uint32_t now = micros();
+    uint32_t dtUs = now - st->lastFrameUs;
+    st->lastFrameUs = now;
+    if (dtUs > FRAME_MAX_US) dtUs = FRAME_MAX_US;
     
-    lastScrollOffset = currentScrollOffset;
-    lastFileCount = currentFileCount;
-    lastSelectedIndex = currentSelectedIndex;
+    if (st->motion == MOTION_FLINGING) {
+        // Integrate position, then decay velocity exponentially (Euler step)
+        st->scrollQ += st->velocity * (int32_t)dtUs / 62500; // px/s * us -> 1/16 px
+        st->velocity -= st->velocity * (int32_t)dtUs / (FLING_TAU_MS * 1000L);
+        
+        int32_t maxScroll = maxScrollPx();
+        if (st->scrollQ <= 0 || st->scrollQ >= (maxScroll << 4)) {
+            setScroll(st->scrollQ >> 4);
+            st->velocity = 0;
+        }
+        if (abs(st->velocity) < FLING_STOP_VELOCITY) {
+            st->motion = MOTION_SNAPPING;
+        }
+    }
     
-    if (scrollChanged || selectionChanged || fullRedraw || fileCountChanged) {
-        SerialUSB.println(F("=== Files Screen Update Complete ===\n"));
+    if (st->motion == MOTION_SNAPPING) {
+        // Ease towards the nearest row boundary
+        int32_t px = st->scrollQ >> 4;
+        int32_t target = ((px + ROW_PITCH / 2) / ROW_PITCH) * ROW_PITCH;
+        if (target > maxScrollPx()) target = maxScrollPx();
+        int32_t diff = target - px;
+        if (diff == 0) {
+            st->motion = MOTION_IDLE;
+        } else {
+            int32_t step = diff / 3;
+            if (step == 0) step = (diff > 0) ? 1 : -1;
+            setScroll(px + step);
+        }
     }
+    
+    applyScroll(st->scrollQ >> 4);
+}
+
+static void files_exit(void)
+{
+    // Other screens draw with an unscrolled panel
+    tft_setScrollArea(0, 0);
+    tft_scrollTo(0);
+    sdBrowser.detachWindow();
+    st = NULL;
 }
 
-void screen_files_handleTouch(int16_t x, int16_t y) {
-    SerialUSB.print(F("Files touch: x=")); SerialUSB.print(x);
+static void handleTap(int16_t x, int16_t y) {
+    SerialUSB.print(F("Files tap: x=")); SerialUSB.print(x);
     SerialUSB.print(F(", y=")); SerialUSB.println(y);
     
-    const int16_t itemHeight = 45;
-    const int16_t margin = 5;
+    if (y < LIST_TOP) return;
     
-    if (touchStartY == -1) {
-        touchStartY = y;
-        lastTouchY = y;
-        SerialUSB.println(F("Touch start"));
-        return;
+    int32_t cy = st->shownPx + (y - LIST_TOP);
+    int row = cy / ROW_PITCH;
+    if (cy % ROW_PITCH >= ITEM_HEIGHT || row >= rowCount()) return;
+    
+    if (sdBrowser.canGoUp()) {
+        if (row == 0) {
+            SerialUSB.println(F("Up button clicked"));
+            sdBrowser.goUp();
+            resetList();
+            ui_requestRedraw();
+            return;
+        }
+        row--;
     }
     
-    int dragDelta = lastTouchY - y;
-    if (abs(dragDelta) > 10) {
-        SerialUSB.print(F("Dragging, delta: ")); SerialUSB.println(dragDelta);
-        sdBrowser.scroll(dragDelta > 0 ? 1 : -1);
-        lastTouchY = y;
-        screen_files_draw();
+    SerialUSB.print(F("File item clicked: index ")); SerialUSB.println(row);
+    FileEntry* entry = sdBrowser.getFile(row);
+    if (!entry) return;
+    
+    if (entry->isDirectory) {
+        sdBrowser.selectFile(row);
+        resetList();
+        ui_requestRedraw();
         return;
     }
     
-    if (abs(y - touchStartY) < 15) {
-        SerialUSB.println(F("Detected click"));
-        int yPos = CONTENT_Y + 35;
-        if (sdBrowser.canGoUp()) {
-            if (y >= yPos && y < yPos + itemHeight) {
-                SerialUSB.println(F("Up button clicked"));
-                sdBrowser.goUp();
-                firstFileDraw = true;
-                ui_requestRedraw();
-                touchStartY = -1; lastTouchY = -1;
-                return;
-            }
-            yPos += itemHeight + 5;
-        }
-        int scrollOffset = sdBrowser.getScrollOffset();
-        for (int i = 0; i < 4; i++) {
-            if ((scrollOffset + i) >= sdBrowser.getFileCount()) break;
-            if (y >= yPos && y < yPos + itemHeight) {
-                SerialUSB.print(F("File item clicked: index ")); SerialUSB.println(scrollOffset + i);
-                FileEntry* entry = sdBrowser.getFile(scrollOffset + i);
-                if (entry && entry->isDirectory) firstFileDraw = true;
-                sdBrowser.selectFile(scrollOffset + i);
-                screen_files_draw();
-                touchStartY = -1; lastTouchY = -1;
-                return;
-            }
-            yPos += itemHeight + 5;
+    int rowBase = sdBrowser.canGoUp() ? 1 : 0;
+    int oldSelected = sdBrowser.getSelectedIndex();
+    sdBrowser.selectFile(row);
+    if (oldSelected >= 0) redrawRow(oldSelected + rowBase);
+    redrawRow(row + rowBase);
+}
+
+static void files_handleEvent(const UIEvent *ev) {
+    switch (ev->type) {
+    case UI_EVENT_TAP:
+        if (st->motion == MOTION_FLINGING || st->motion == MOTION_SNAPPING) {
+            // A tap on a moving list stops it instead of opening a row
+            st->velocity = 0;
+            st->motion = MOTION_SNAPPING;
+            break;
         }
+        handleTap(ev->x, ev->y);
+        break;
+        
+    case UI_EVENT_DRAG_START:
+        st->velocity = 0;
+        st->motion = MOTION_DRAGGING;
+        break;
+        
+    case UI_EVENT_DRAG:
+        // Content follows the finger pixel for pixel
+        setScroll((st->scrollQ >> 4) - ev->dy);
+        applyScroll(st->scrollQ >> 4);
+        break;
+        
+    case UI_EVENT_DRAG_END:
+        st->motion = MOTION_SNAPPING;
+        break;
+        
+    case UI_EVENT_FLING:
+        st->velocity = -ev->vy;
+        st->motion = MOTION_FLINGING;
+        st->lastFrameUs = micros();
+        break;
+        
+    default:
+        break;
     }
-    SerialUSB.println(F("Touch released"));
-    touchStartY = -1; lastTouchY = -1;
-}
\ No newline at end of file
+}
+
+const UIPage page_files = {
+    files_enter,      // onEnter
+    files_exit,       // onExit (restores the unscrolled panel)
+    files_update,     // onUpdate (kinetic scrolling physics)
+    files_drawSlice,  // onDraw
+    files_handleEvent // onEvent
+};
@@ -1,9 +1,8 @@
 #ifndef FILES_PAGE_H
 #define FILES_PAGE_H
 
-#include <stdint.h>
+#include "../../ui_types.h"
 
-void screen_files_draw(void);
-void screen_files_handleTouch(int16_t x, int16_t y);
+extern const UIPage page_files;
 
-#endif
\ No newline at end of file
+#endif
@@ -3,34 +3,51 @@
 #include "../../drawing.h"
 #include "../../ui_types.h"
 #include "../../fonts_pro.h" // Access to MyFontPro
+#include "../../perf.h"
 
-// Helper to draw values dynamically with the new font
-static void drawValueDynamic(int16_t x, int16_t y, int16_t val, uint16_t color) {
-    char buf[10];
-    snprintf(buf, 10, "%d%%", val);
-    
-    // Clear previous text area
-    // Note: Adjust height/y based on your font size
-    draw_fillRect(x, y - 12, 60, 16, COLOR_WHITE);
-    
-    // FIX: Use 'buf' here, not 'label'. And use MyFontPro.
-    draw_GFXtext(x, y, buf, &MyFontPro, color); 
+// Draw a sensor card and bind its value slot to the data binding system
+static void drawSensorCard(int16_t x, int16_t y, int16_t w, int16_t h,
+                           LabelID id, uint16_t color) {
+    draw_cardFrame(x, y, w, h, labels_en[id], color);
+
+    // Value slot sits where draw_card_modern puts its value text
+    ui_registerValue(id, x + 8, y + 58, w - 16, 21, "%d%%", &MyFontPro,
+                     COLOR_BLACK, COLOR_WHITE);
 }
 
-void screen_home_draw(void)
+// Slice 0 clears the content area, slices 1-4 draw one card each
+static bool home_drawSlice(uint8_t slice)
 {
-    // Clear content area
-    draw_fillRect(0, CONTENT_Y, SCREEN_WIDTH, CONTENT_HEIGHT, 0xF7BE); // Off-white background
-
+    PERF_SCOPE(PERF_ZONE_HOME);
     const int16_t cardW = (SCREEN_WIDTH - 30) / 2;
     const int16_t cardH = 90;
     const int16_t margin = 10;
+    const int16_t row1 = CONTENT_Y + 20;
+    const int16_t row2 = CONTENT_Y + 20 + cardH + 15;
 
-    // Row 1
-    draw_card_modern(margin, CONTENT_Y + 20, cardW, cardH, "Moisture", 65, COLOR_CYAN);
-    draw_card_modern(margin + cardW + 10, CONTENT_Y + 20, cardW, cardH, "Nitrogen", 42, COLOR_GREEN);
+    switch (slice) {
+    case 0:
+        draw_fillRect(0, CONTENT_Y, SCREEN_WIDTH, CONTENT_HEIGHT, 0xF7BE); // Off-white background
+        return true;
+    case 1:
+        drawSensorCard(margin, row1, cardW, cardH, LABEL_MOISTURE, COLOR_CYAN);
+        return true;
+    case 2:
+        drawSensorCard(margin + cardW + 10, row1, cardW, cardH, LABEL_NITROGEN, COLOR_GREEN);
+        return true;
+    case 3:
+        drawSensorCard(margin, row2, cardW, cardH, LABEL_PHOSPHORUS, COLOR_ORANGE);
+        return true;
+    default:
+        drawSensorCard(margin + cardW + 10, row2, cardW, cardH, LABEL_POTASSIUM, COLOR_MAGENTA);
+        return false;
+    }
+}
 
-    // Row 2
-    draw_card_modern(margin, CONTENT_Y + 20 + cardH + 15, cardW, cardH, "Phosphorus", 38, COLOR_ORANGE);
-    draw_card_modern(margin + cardW + 10, CONTENT_Y + 20 + cardH + 15, cardW, cardH, "Potassium", 85, COLOR_MAGENTA);
-}
\ No newline at end of file
+const UIPage page_home = {
+    NULL,           // onEnter
+    NULL,           // onExit
+    NULL,           // onUpdate
+    home_drawSlice, // onDraw
+    NULL            // onEvent (no gestures)
+};
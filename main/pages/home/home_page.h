@@ -1,6 +1,8 @@
 #ifndef HOME_PAGE_H
 #define HOME_PAGE_H
 
-void screen_home_draw(void);
+#include "../../ui_types.h"
 
-#endif
\ No newline at end of file
+extern const UIPage page_home;
+
+#endif
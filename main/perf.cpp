@@ -0,0 +1,103 @@
+/**
+ * @file perf.cpp
+ * @brief Performance Counters Implementation
+ */
+
+#include "perf.h"
+
+#if PERF_ENABLED
+
+// ===================================
+// State
+// ===================================
+
+PerfCounters perfCounters;
+
+static PerfReport current;
+static PerfReport last;
+static PerfCounters windowStart;
+static uint32_t windowStartMs = 0;
+
+static const char *const zoneNames[PERF_ZONE_COUNT] = {
+    "draw", "home", "files", "ai", "settings", "input", "gpsdbg", "gps"};
+
+// ===================================
+// Scoped Timer
+// ===================================
+
+PerfScope::PerfScope(PerfZone z)
+{
+    zone = z;
+    start = perfCounters;
+    startUs = micros();
+}
+
+PerfScope::~PerfScope()
+{
+    uint32_t elapsed = (uint32_t)(micros() - startUs);
+    PerfZoneStats *s = &current.zones[zone];
+
+    s->calls++;
+    s->totalUs += elapsed;
+    if (elapsed > s->maxUs)
+    {
+        s->maxUs = elapsed;
+    }
+    s->counts.pixels += perfCounters.pixels - start.pixels;
+    s->counts.spiBytes += perfCounters.spiBytes - start.spiBytes;
+    s->counts.commands += perfCounters.commands - start.commands;
+    s->counts.windows += perfCounters.windows - start.windows;
+}
+
+// ===================================
+// Reporting
+// ===================================
+
+void perf_frame(void)
+{
+    current.frames++;
+}
+
+void perf_report(void)
+{
+    uint32_t now = millis();
+
+    current.periodMs = now - windowStartMs;
+    current.counts.pixels = perfCounters.pixels - windowStart.pixels;
+    current.counts.spiBytes = perfCounters.spiBytes - windowStart.spiBytes;
+    current.counts.commands = perfCounters.commands - windowStart.commands;
+    current.counts.windows = perfCounters.windows - windowStart.windows;
+
+    last = current;
+    memset(&current, 0, sizeof(current));
+    windowStart = perfCounters;
+    windowStartMs = now;
+
+    char line[112];
+    snprintf(line, sizeof(line), "perf %lums fr=%lu px=%lu spi=%lu cmd=%lu win=%lu",
+             (unsigned long)last.periodMs, (unsigned long)last.frames,
+             (unsigned long)last.counts.pixels, (unsigned long)last.counts.spiBytes,
+             (unsigned long)last.counts.commands, (unsigned long)last.counts.windows);
+    SerialUSB.println(line);
+
+    for (int i = 0; i < PERF_ZONE_COUNT; i++)
+    {
+        const PerfZoneStats *s = &last.zones[i];
+        if (s->calls == 0)
+        {
+            continue;
+        }
+        snprintf(line, sizeof(line), "  %-8s n=%lu us=%lu max=%lu px=%lu spi=%lu win=%lu",
+                 zoneNames[i], (unsigned long)s->calls, (unsigned long)s->totalUs,
+                 (unsigned long)s->maxUs, (unsigned long)s->counts.pixels,
+                 (unsigned long)s->counts.spiBytes, (unsigned long)s->counts.windows);
+        SerialUSB.println(line);
+    }
+}
+
+const PerfReport *perf_getReport(void)
+{
+    return &last;
+}
+
+#endif // PERF_ENABLED
@@ -0,0 +1,118 @@
+/**
+ * @file perf.h
+ * @brief Frame-Level Performance Counters and Scoped Timers
+ *
+ * Enabled with PERF_ENABLED in config.h. The TFT driver counts pixels, SPI
+ * bytes, commands and window sets; PERF_SCOPE() attributes those counts
+ * and elapsed time to a named zone. A summary of the last second is
+ * printed over SerialUSB (stdout in the simulator).
+ *
+ * When compiled out every macro expands to nothing.
+ */
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===================================
+// Timed Zones
+// ===================================
+typedef enum
+{
+    PERF_ZONE_DRAW_SCREEN = 0,
+    PERF_ZONE_HOME,
+    PERF_ZONE_FILES,
+    PERF_ZONE_AI,
+    PERF_ZONE_SETTINGS,
+    PERF_ZONE_INPUT,
+    PERF_ZONE_GPS_DEBUG,
+    PERF_ZONE_GPS_UPDATE,
+    PERF_ZONE_COUNT
+} PerfZone;
+
+// ===================================
+// Counter Structures
+// ===================================
+typedef struct
+{
+    uint32_t pixels;
+    uint32_t spiBytes;
+    uint32_t commands;
+    uint32_t windows;
+} PerfCounters;
+
+typedef struct
+{
+    uint32_t calls;
+    uint32_t totalUs;
+    uint32_t maxUs;
+    PerfCounters counts; // Driver work done inside the zone
+} PerfZoneStats;
+
+typedef struct
+{
+    uint32_t periodMs;
+    uint32_t frames;
+    PerfCounters counts;
+    PerfZoneStats zones[PERF_ZONE_COUNT];
+} PerfReport;
+
+#if PERF_ENABLED
+
+// Running driver totals, bumped by PERF_COUNT()
+extern PerfCounters perfCounters;
+
+// ===================================
+// Scoped Timer
+// ===================================
+class PerfScope
+{
+public:
+    PerfScope(PerfZone zone);
+    ~PerfScope();
+
+private:
+    PerfZone zone;
+    uint32_t startUs;
+    PerfCounters start;
+};
+
+#define PERF_COUNT(field, n) (perfCounters.field += (n))
+#define PERF_SCOPE_NAME2(line) perfScope_##line
+#define PERF_SCOPE_NAME(line) PERF_SCOPE_NAME2(line)
+#define PERF_SCOPE(zone) PerfScope PERF_SCOPE_NAME(__LINE__)(zone)
+#define PERF_FRAME() perf_frame()
+
+// ===================================
+// Performance Functions
+// ===================================
+
+/**
+ * @brief Count one completed UI frame
+ */
+void perf_frame(void);
+
+/**
+ * @brief Close the current window, print it and start a new one
+ *
+ * Run once per PERF_REPORT_MS from the scheduler.
+ */
+void perf_report(void);
+
+/**
+ * @brief Get the last completed window (for the simulator / debug page)
+ * @return Pointer to the last report
+ */
+const PerfReport *perf_getReport(void);
+
+#else
+
+#define PERF_COUNT(field, n) ((void)0)
+#define PERF_SCOPE(zone) ((void)0)
+#define PERF_FRAME() ((void)0)
+
+#endif // PERF_ENABLED
+
+#endif // PERF_H
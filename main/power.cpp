@@ -0,0 +1,83 @@
+/**
+ * @file power.cpp
+ * @brief Low-Power Idle Implementation
+ */
+
+#include "power.h"
+#include "input.h"
+#include "touch_driver.h"
+
+#ifndef ARDUINO_ARCH_SAMD
+#include <unistd.h>
+#endif
+
+// ===================================
+// State
+// ===================================
+
+static PowerStats powerStats;
+static uint32_t windowStartUs = 0;
+
+// One wait for an interrupt; on the host a 1 ms SysTick is emulated
+static void power_wait(uint32_t remainingUs)
+{
+#ifdef ARDUINO_ARCH_SAMD
+    (void)remainingUs;
+    __DSB();
+    __WFI();
+#else
+    usleep(remainingUs < 1000 ? remainingUs : 1000);
+#endif
+}
+
+// ===================================
+// Public API
+// ===================================
+
+void power_idle(uint32_t slackUs)
+{
+    if (slackUs < POWER_MIN_SLEEP_US)
+    {
+        return;
+    }
+
+    uint32_t start = micros();
+    uint32_t elapsed = 0;
+    while (elapsed < slackUs)
+    {
+        // A new contact is sampled now rather than at the next touch slot
+        if (TOUCH_IRQ_WIRED && !input_isTouching() && touch_irqActive())
+        {
+            input_poll();
+            powerStats.touchWakes++;
+            break;
+        }
+        power_wait(slackUs - elapsed);
+        elapsed = micros() - start;
+    }
+
+    powerStats.asleepUs += elapsed;
+    powerStats.sleeps++;
+}
+
+const PowerStats *power_getStats(void)
+{
+    powerStats.windowUs = micros() - windowStartUs;
+    return &powerStats;
+}
+
+void power_report(void)
+{
+    power_getStats();
+
+    char line[112];
+    uint32_t pct10 = powerStats.windowUs ? (uint32_t)((uint64_t)powerStats.asleepUs * 1000 / powerStats.windowUs) : 0;
+    snprintf(line, sizeof(line), "power asleep=%lu.%lu%% sleeps=%lu touch-wakes=%lu over %lums",
+             (unsigned long)(pct10 / 10), (unsigned long)(pct10 % 10),
+             (unsigned long)powerStats.sleeps, (unsigned long)powerStats.touchWakes,
+             (unsigned long)(powerStats.windowUs / 1000));
+    SerialUSB.println(line);
+
+    memset(&powerStats, 0, sizeof(powerStats));
+    windowStartUs = micros();
+}
@@ -0,0 +1,54 @@
+/**
+ * @file power.h
+ * @brief Low-Power Idle
+ *
+ * When the scheduler has nothing due and no background work is queued,
+ * the CPU sleeps with WFI until the next task deadline. SysTick, USB and
+ * the A9G ring's DMA pass interrupt wake it (Serial1 bytes land in the
+ * ring without waking the CPU); with PENIRQ wired a touch also ends the
+ * sleep early and is sampled straight away. Time spent asleep is the
+ * current-draw proxy reported by power_report().
+ *
+ * The simulator sleeps the host thread instead of WFI, so the same
+ * percentage can be compared on the desktop.
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===================================
+// Power Statistics
+// ===================================
+typedef struct
+{
+    uint32_t asleepUs;   // Time in WFI this window
+    uint32_t windowUs;   // Length of this window
+    uint32_t sleeps;     // power_idle() calls that slept
+    uint32_t touchWakes; // Sleeps cut short by PENIRQ
+} PowerStats;
+
+// ===================================
+// Power Functions
+// ===================================
+
+/**
+ * @brief Sleep until the next deadline - call when nothing else is due
+ * @param slackUs Time until the next task is due (sched_slackUs())
+ */
+void power_idle(uint32_t slackUs);
+
+/**
+ * @brief Get statistics for the current window
+ * @return Pointer to statistics (windowUs is updated on each call)
+ */
+const PowerStats *power_getStats(void);
+
+/**
+ * @brief Print % time asleep since the last report and start a new window
+ */
+void power_report(void);
+
+#endif // POWER_H
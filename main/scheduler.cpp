@@ -0,0 +1,277 @@
+/**
+ * @file scheduler.cpp
+ * @brief Cooperative Deadline Scheduler Implementation
+ */
+
+#include "scheduler.h"
+
+// ===================================
+// Task Table
+// ===================================
+
+static SchedTask tasks[MAX_TASKS];
+static int taskCount = 0;
+static int runningTask = -1;
+static SchedLatency latency;
+
+// Signed distance from now to a deadline, safe across micros() wrap
+static int32_t untilUs(uint32_t deadline, uint32_t now)
+{
+    return (int32_t)(deadline - now);
+}
+
+// ===================================
+// Task Registration
+// ===================================
+
+int sched_addTask(const char *name, void (*fn)(void), uint32_t periodUs,
+                  uint32_t budgetUs, TaskPriority priority)
+{
+    if (taskCount >= MAX_TASKS || fn == NULL)
+    {
+        return -1;
+    }
+
+    SchedTask *t = &tasks[taskCount];
+    memset(t, 0, sizeof(SchedTask));
+    t->name = name;
+    t->fn = fn;
+    t->periodUs = periodUs;
+    t->budgetUs = budgetUs;
+    t->priority = priority;
+    t->nextDueUs = micros();
+    t->enabled = true;
+
+    return taskCount++;
+}
+
+void sched_setEnabled(int id, bool enabled)
+{
+    if (id < 0 || id >= taskCount)
+    {
+        return;
+    }
+    if (enabled && !tasks[id].enabled)
+    {
+        tasks[id].nextDueUs = micros();
+    }
+    tasks[id].enabled = enabled;
+}
+
+// ===================================
+// Scheduling
+// ===================================
+
+// A task fits if it can finish before any higher-priority task is due.
+// Tasks that are a whole period late run regardless, so nothing starves.
+static bool sched_fits(const SchedTask *t, uint32_t now)
+{
+    if (untilUs(t->nextDueUs + t->periodUs, now) <= 0)
+    {
+        return true;
+    }
+    for (int i = 0; i < taskCount; i++)
+    {
+        const SchedTask *other = &tasks[i];
+        if (!other->enabled || other->priority >= t->priority)
+        {
+            continue;
+        }
+        if (untilUs(other->nextDueUs, now) < (int32_t)t->budgetUs)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint8_t sched_bucket(uint32_t us)
+{
+    uint8_t b = 0;
+    while (us > 1 && b < SCHED_HIST_BUCKETS - 1)
+    {
+        us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+static void sched_recordLatency(const SchedTask *t, uint32_t elapsed)
+{
+    latency.buckets[sched_bucket(elapsed)]++;
+    if (elapsed > latency.maxUs)
+    {
+        latency.maxUs = elapsed;
+        latency.maxTask = t->name;
+    }
+    if (elapsed >= SCHED_STALL_US)
+    {
+        latency.stalls++;
+        latency.lastStallTask = t->name;
+        latency.lastStallUs = elapsed;
+        latency.lastStallMs = millis();
+    }
+}
+
+bool sched_run(void)
+{
+    uint32_t now = micros();
+
+    // Highest priority due task, earliest deadline first within a priority
+    int pick = -1;
+    for (int i = 0; i < taskCount; i++)
+    {
+        SchedTask *t = &tasks[i];
+        if (!t->enabled || untilUs(t->nextDueUs, now) > 0)
+        {
+            continue;
+        }
+        if (pick >= 0)
+        {
+            SchedTask *p = &tasks[pick];
+            if (t->priority > p->priority)
+            {
+                continue;
+            }
+            if (t->priority == p->priority &&
+                untilUs(t->nextDueUs, p->nextDueUs) >= 0)
+            {
+                continue;
+            }
+        }
+        if (!sched_fits(t, now))
+        {
+            if (!t->deferred)
+            {
+                t->deferred = true;
+                t->deferrals++;
+            }
+            continue;
+        }
+        pick = i;
+    }
+
+    if (pick < 0)
+    {
+        return false;
+    }
+
+    SchedTask *t = &tasks[pick];
+    t->deferred = false;
+    runningTask = pick;
+    uint32_t start = micros();
+    t->fn();
+    uint32_t elapsed = micros() - start;
+    runningTask = -1;
+
+    t->runs++;
+    t->totalUs += elapsed;
+    if (elapsed > t->maxUs)
+    {
+        t->maxUs = elapsed;
+    }
+    if (elapsed > t->budgetUs)
+    {
+        t->overruns++;
+    }
+    sched_recordLatency(t, elapsed);
+
+    // Keep a fixed cadence; if a whole period was missed, restart from now
+    t->nextDueUs += t->periodUs;
+    now = micros();
+    if (untilUs(t->nextDueUs, now) < 0)
+    {
+        t->late++;
+        t->nextDueUs = now + t->periodUs;
+    }
+
+    return true;
+}
+
+uint32_t sched_slackUs(void)
+{
+    uint32_t now = micros();
+    int32_t slack = INT32_MAX;
+    for (int i = 0; i < taskCount; i++)
+    {
+        if (!tasks[i].enabled)
+        {
+            continue;
+        }
+        int32_t until = untilUs(tasks[i].nextDueUs, now);
+        if (until < slack)
+        {
+            slack = until;
+        }
+    }
+    return (slack > 0) ? (uint32_t)slack : 0;
+}
+
+const char *sched_currentTask(void)
+{
+    return (runningTask >= 0) ? tasks[runningTask].name : NULL;
+}
+
+// ===================================
+// Statistics
+// ===================================
+
+const SchedLatency *sched_getLatency(void)
+{
+    return &latency;
+}
+
+const SchedTask *sched_getTask(int id)
+{
+    if (id < 0 || id >= taskCount)
+    {
+        return NULL;
+    }
+    return &tasks[id];
+}
+
+int sched_getTaskCount(void)
+{
+    return taskCount;
+}
+
+void sched_printStats(void)
+{
+    SerialUSB.println(F("--- Scheduler: task runs avg/max us overrun late defer ---"));
+    for (int i = 0; i < taskCount; i++)
+    {
+        const SchedTask *t = &tasks[i];
+        char line[80];
+        snprintf(line, sizeof(line), "%-8s %6lu %6lu/%-7lu %4lu %4lu %5lu",
+                 t->name, (unsigned long)t->runs,
+                 (unsigned long)(t->runs ? t->totalUs / t->runs : 0),
+                 (unsigned long)t->maxUs, (unsigned long)t->overruns,
+                 (unsigned long)t->late, (unsigned long)t->deferrals);
+        SerialUSB.println(line);
+    }
+
+    char line[96];
+    snprintf(line, sizeof(line), "loop max=%luus (%s) stalls=%lu last=%luus (%s)",
+             (unsigned long)latency.maxUs, latency.maxTask ? latency.maxTask : "-",
+             (unsigned long)latency.stalls, (unsigned long)latency.lastStallUs,
+             latency.lastStallTask ? latency.lastStallTask : "-");
+    SerialUSB.println(line);
+
+    // Non-empty log2 buckets as "lower-bound-us:count"
+    int len = snprintf(line, sizeof(line), "loop hist");
+    for (int b = 0; b < SCHED_HIST_BUCKETS; b++)
+    {
+        if (latency.buckets[b] == 0)
+        {
+            continue;
+        }
+        if (len > (int)sizeof(line) - 20)
+        {
+            SerialUSB.println(line);
+            len = snprintf(line, sizeof(line), "         ");
+        }
+        len += snprintf(line + len, sizeof(line) - len, " %lu:%lu",
+                        1UL << b, (unsigned long)latency.buckets[b]);
+    }
+    SerialUSB.println(line);
+}
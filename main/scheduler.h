@@ -0,0 +1,132 @@
+/**
+ * @file scheduler.h
+ * @brief Cooperative Deadline Scheduler
+ *
+ * Replaces the loop() polling chain. Each task has a period, a run-time
+ * budget and a priority. A task only starts if its budget fits before the
+ * next deadline of every higher-priority task, so the UI frame task keeps
+ * its slot and background work runs in the slack between frames.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===================================
+// Task Priorities (lower runs first)
+// ===================================
+typedef enum
+{
+    TASK_PRIO_UI = 0,
+    TASK_PRIO_HIGH,
+    TASK_PRIO_NORMAL,
+    TASK_PRIO_LOW
+} TaskPriority;
+
+// ===================================
+// Task Structure
+// ===================================
+typedef struct
+{
+    const char *name;
+    void (*fn)(void);
+    uint32_t periodUs;
+    uint32_t budgetUs;
+    TaskPriority priority;
+    uint32_t nextDueUs;
+    bool enabled;
+    bool deferred;      // Due but waiting for slack this period
+
+    // Statistics
+    uint32_t runs;
+    uint32_t totalUs;   // Accumulated run time (wraps after ~71 min of CPU)
+    uint32_t maxUs;     // Longest single run
+    uint32_t overruns;  // Runs that exceeded budgetUs
+    uint32_t late;      // Deadlines missed by a whole period or more
+    uint32_t deferrals; // Periods in which it had to wait for slack
+} SchedTask;
+
+// ===================================
+// Loop Latency
+// ===================================
+// How long loop() was held by single task runs. Bucket i counts runs of
+// [2^i, 2^(i+1)) us (bucket 0 includes 0 us, the last is open-ended).
+typedef struct
+{
+    uint32_t buckets[SCHED_HIST_BUCKETS];
+    uint32_t maxUs;
+    const char *maxTask;       // Task of the longest run
+    uint32_t stalls;           // Runs of SCHED_STALL_US or more
+    const char *lastStallTask;
+    uint32_t lastStallUs;
+    uint32_t lastStallMs;      // millis() when it ended
+} SchedLatency;
+
+// ===================================
+// Scheduler Functions
+// ===================================
+
+/**
+ * @brief Register a periodic task
+ * @param name Short name for statistics
+ * @param fn Task function, must return within roughly budgetUs
+ * @param periodUs Period between runs in microseconds
+ * @param budgetUs Expected worst-case run time in microseconds
+ * @param priority Task priority
+ * @return Task ID or -1 if the table is full
+ */
+int sched_addTask(const char *name, void (*fn)(void), uint32_t periodUs,
+                  uint32_t budgetUs, TaskPriority priority);
+
+/**
+ * @brief Enable or disable a task (re-enabled tasks are due immediately)
+ * @param id Task ID
+ * @param enabled New state
+ */
+void sched_setEnabled(int id, bool enabled);
+
+/**
+ * @brief Run at most one due task - call this from loop()
+ * @return true if a task ran
+ */
+bool sched_run(void);
+
+/**
+ * @brief Time until the earliest enabled task is due
+ * @return Microseconds of slack (0 if something is due now)
+ */
+uint32_t sched_slackUs(void);
+
+/**
+ * @brief Name of the task currently running
+ * @return Task name or NULL when called outside a task
+ */
+const char *sched_currentTask(void);
+
+/**
+ * @brief Get the loop latency histogram and stall record
+ * @return Pointer to latency statistics
+ */
+const SchedLatency *sched_getLatency(void);
+
+/**
+ * @brief Get a task by ID (for statistics)
+ * @param id Task ID
+ * @return Pointer to task or NULL
+ */
+const SchedTask *sched_getTask(int id);
+
+/**
+ * @brief Get the number of registered tasks
+ * @return Task count
+ */
+int sched_getTaskCount(void);
+
+/**
+ * @brief Print per-task statistics over SerialUSB
+ */
+void sched_printStats(void);
+
+#endif // SCHEDULER_H
@@ -11,6 +11,8 @@
 #include <stdio.h>
 #include <string.h> // Added for strlen/strrchr
 #include "a9g_gps.h"
+#include "perf.h"
+#include "scheduler.h"
 
 // External reference to global SD browser
 extern FileBrowser sdBrowser;
@@ -118,14 +120,19 @@ void drawGPSText(const char* text, int16_t x, int16_t y) {
 // AI Screen
 // ===================================
 
-void screen_ai_draw(void)
+static bool screen_ai_draw(uint8_t slice)
 {
+    (void)slice; // Drawn in one slice
+    PERF_SCOPE(PERF_ZONE_AI);
     draw_fillRect(0, CONTENT_Y, SCREEN_WIDTH, CONTENT_HEIGHT, COLOR_WHITE);
     const int16_t margin = 10;
     draw_fillRect(margin, CONTENT_Y + margin, SCREEN_WIDTH - (margin * 2), 60, COLOR_CYAN);
     draw_fillRect(margin, CONTENT_Y + margin + 70, SCREEN_WIDTH - (margin * 2), 100, COLOR_LIGHTGRAY);
+    return false;
 }
 
+static const UIPage page_ai = {NULL, NULL, NULL, screen_ai_draw, NULL};
+
 // ===================================
 // Settings Screen
 // ===================================
@@ -134,8 +141,10 @@ static void onWifiClick(void) { SerialUSB.println(F("WiFi button clicked")); }
 static void onLanguageClick(void) { SerialUSB.println(F("Language button clicked")); }
 static void onAboutClick(void) { SerialUSB.println(F("About button clicked")); }
 
-void screen_settings_draw(void)
+static bool screen_settings_draw(uint8_t slice)
 {
+    (void)slice;
+    PERF_SCOPE(PERF_ZONE_SETTINGS);
     draw_fillRect(0, CONTENT_Y, SCREEN_WIDTH, CONTENT_HEIGHT, COLOR_WHITE);
     const int16_t margin = 10;
     const int16_t buttonHeight = 40;
@@ -151,14 +160,19 @@ void screen_settings_draw(void)
         UIButton *btn = ui_getButton(i);
         if (btn != NULL) draw_button(btn);
     }
+    return false;
 }
 
+static const UIPage page_settings = {NULL, NULL, NULL, screen_settings_draw, NULL};
+
 // ===================================
 // Input Screen
 // ===================================
 
-void screen_input_draw(void)
+static bool screen_input_draw(uint8_t slice)
 {
+    (void)slice;
+    PERF_SCOPE(PERF_ZONE_INPUT);
     draw_fillRect(0, CONTENT_Y, SCREEN_WIDTH, CONTENT_HEIGHT, COLOR_WHITE);
     const int16_t margin = 20;
     draw_fillRect(margin, CONTENT_Y + 20, SCREEN_WIDTH - (margin * 2), 40, COLOR_LIGHTGRAY);
@@ -185,68 +199,210 @@ void screen_input_draw(void)
     draw_fillRect(startX + 2, funcY + 2, keyW * 2 + keySpacing - 4, keyH - 4, COLOR_WHITE);
     draw_fillRect(startX + (keyW + keySpacing) * 3, funcY, keyW * 2 + keySpacing, keyH, COLOR_GREEN);
     draw_fillRect(startX + (keyW + keySpacing) * 3 + 2, funcY + 2, keyW * 2 + keySpacing - 4, keyH - 4, COLOR_WHITE);
+    return false;
 }
 
+static const UIPage page_input = {NULL, NULL, NULL, screen_input_draw, NULL};
+
 // ===================================
 // GPS Debug Screen
 // ===================================
 
-void screen_gps_debug_draw(void)
+#define GPS_DBG_MARGIN 5
+#define GPS_DBG_W (SCREEN_WIDTH - 2 * GPS_DBG_MARGIN)
+#define GPS_DBG_FIX_Y (CONTENT_Y + 30)      // Status, lat and lon rows
+#define GPS_DBG_POWER_Y (CONTENT_Y + 72)    // Duty cycle mode and TTFF rows
+#define GPS_DBG_CMD_Y (CONTENT_Y + 118)
+#define GPS_DBG_NMEA_Y (CONTENT_Y + 150)    // Newest sentence
+#define GPS_DBG_LOOP_Y (CONTENT_Y + 165)    // Latency header and histogram
+#define GPS_DBG_ROW_H 14
+
+typedef struct {
+    uint32_t lastLoopDraw;
+    uint32_t seenFix;           // GPS state sequence numbers last drawn
+    uint32_t seenDebug;
+    uint32_t seenNmea;
+    uint32_t seenPower;
+    char fixText[3][48];        // Rows as drawn, unchanged ones are skipped
+    char powerText[2][48];
+    char cmdText[32];
+} GPSDebugState;
+
+static GPSDebugState *gpsDebug = NULL;
+
+static void screen_gps_debug_enter(void)
+{
+    gpsDebug = (GPSDebugState *)ui_pageAlloc(sizeof(GPSDebugState));
+    if (gpsDebug == NULL) return; // ui_setScreen() goes back
+    memset(gpsDebug, 0, sizeof(GPSDebugState));
+
+    // NMEA history is only worth its RAM while someone can see it
+    NMEABuffer *history = (NMEABuffer *)ui_pageAlloc(sizeof(NMEABuffer));
+    if (history == NULL) return;
+    gpsModule.attachNMEAHistory(history);
+}
+
+static void screen_gps_debug_exit(void)
+{
+    gpsModule.detachNMEAHistory();
+    gpsDebug = NULL;
+}
+
+// One text row; with shown, only drawn when the text differs from it
+static void gpsDebugRow(int16_t y, const char *text, uint16_t bg, char *shown, size_t shownLen)
+{
+    if (shown != NULL) {
+        if (strncmp(shown, text, shownLen - 1) == 0) return;
+        strncpy(shown, text, shownLen - 1);
+        shown[shownLen - 1] = '\0';
+    }
+    draw_fillRect(GPS_DBG_MARGIN, y, GPS_DBG_W, 12, bg);
+    drawTruncatedText(GPS_DBG_MARGIN + 3, y + 2, text, GPS_DBG_W - 6, bg);
+}
+
+static void gpsDebugHeader(int16_t y, const char *text)
+{
+    draw_fillRect(GPS_DBG_MARGIN, y, GPS_DBG_W, 15, COLOR_DARKGRAY);
+    drawTruncatedText(GPS_DBG_MARGIN + 3, y + 4, text, GPS_DBG_W - 6, COLOR_DARKGRAY);
+}
+
+static void gpsDebugDrawFix(void)
+{
+    const GPSData *gpsData = gpsModule.getGPSData();
+    char text[48], degText[16];
+
+    if (gpsData->valid) snprintf(text, sizeof(text), "Status: VALID FIX  %s", gpsData->lastUpdate);
+    else snprintf(text, sizeof(text), "Status: NO FIX  %u in view", gpsData->satsInView);
+    gpsDebugRow(GPS_DBG_FIX_Y, text, gpsData->valid ? COLOR_GREEN : COLOR_RED,
+                gpsDebug->fixText[0], sizeof(gpsDebug->fixText[0]));
+
+    // Without a fix, the cell tower position if there is one
+    GPSLocation loc;
+    bool cell = !gpsData->valid && gpsModule.getLocation(&loc);
+
+    geo_formatE7(degText, sizeof(degText), cell ? loc.latE7 : gpsData->latE7, 6);
+    if (cell) snprintf(text, sizeof(text), "Lat: %s  cell ~%um", degText, loc.accuracyM);
+    else snprintf(text, sizeof(text), "Lat: %s  Alt %.1fm  %u sats",
+                  degText, gpsData->altitude, gpsData->satellites);
+    gpsDebugRow(GPS_DBG_FIX_Y + GPS_DBG_ROW_H, text, COLOR_LIGHTGRAY,
+                gpsDebug->fixText[1], sizeof(gpsDebug->fixText[1]));
+
+    geo_formatE7(degText, sizeof(degText), cell ? loc.lonE7 : gpsData->lonE7, 6);
+    snprintf(text, sizeof(text), "Lon: %s  HDOP %.1f  %.1fkm/h",
+             degText, gpsData->hdop, gpsData->speedKmh);
+    gpsDebugRow(GPS_DBG_FIX_Y + 2 * GPS_DBG_ROW_H, text, COLOR_LIGHTGRAY,
+                gpsDebug->fixText[2], sizeof(gpsDebug->fixText[2]));
+}
+
+// Receiver mode with its share of on time, then time-to-first-fix
+static void gpsDebugDrawPower(void)
+{
+    static const char *const modeNames[] = {"TRACK 1s", "SLOW", "OFF"};
+    const GPSPowerInfo *power = gpsModule.getPowerInfo();
+    char text[48];
+
+    uint32_t onPct = power->upMs ? (uint32_t)((uint64_t)power->onMs * 100 / power->upMs) : 100;
+    snprintf(text, sizeof(text), "Mode: %s (%s) on %lu%%", modeNames[power->mode],
+             power->reason, (unsigned long)onPct);
+    gpsDebugRow(GPS_DBG_POWER_Y, text, (power->mode == GPS_MODE_OFF) ? COLOR_LIGHTGRAY : COLOR_CYAN,
+                gpsDebug->powerText[0], sizeof(gpsDebug->powerText[0]));
+
+    // Acquiring: how long so far; otherwise the last TTFF of each start kind
+    static const char *const startNames[] = {"cold", "warm", "AGPS"};
+    if (power->acquiring) {
+        snprintf(text, sizeof(text), "TTFF: %s start, acquiring %lus", startNames[power->start],
+                 (unsigned long)((millis() - power->acquireMs) / 1000));
+    } else {
+        int n = snprintf(text, sizeof(text), "TTFF");
+        for (uint8_t k = 0; k < GPS_START_KINDS; k++) {
+            if (power->ttff[k].count == 0) continue;
+            n += snprintf(text + n, sizeof(text) - n, " %s %lus", startNames[k],
+                          (unsigned long)(power->ttff[k].lastMs / 1000));
+        }
+        if (n == 4) {
+            snprintf(text, sizeof(text), "TTFF: none yet, %u failed", power->ttffFails);
+        }
+    }
+    gpsDebugRow(GPS_DBG_POWER_Y + GPS_DBG_ROW_H, text, COLOR_LIGHTGRAY,
+                gpsDebug->powerText[1], sizeof(gpsDebug->powerText[1]));
+}
+
+static void gpsDebugDrawCommand(void)
+{
+    gpsDebugRow(GPS_DBG_CMD_Y, gpsModule.getDebugInfo()->lastCommand, COLOR_YELLOW,
+                gpsDebug->cmdText, sizeof(gpsDebug->cmdText));
+}
+
+// Most recent NMEA sentences, newest first
+static void gpsDebugDrawNmea(void)
 {
+    const NMEABuffer *nmea = gpsModule.getNMEAHistory();
+    const char *line = "-";
+    if (nmea && nmea->count > 0) {
+        line = nmea->sentences[(nmea->writeIndex + NMEA_BUFFER_SIZE - 1) % NMEA_BUFFER_SIZE];
+    }
+    gpsDebugRow(GPS_DBG_NMEA_Y, line, COLOR_LIGHTGRAY, NULL, 0);
+}
+
+// Bar per log2 bucket, height by log2 of the count so rare stalls still show
+static void drawLatencyHistogram(int16_t x, int16_t y, int16_t w, int16_t h, const SchedLatency *lat)
+{
+    draw_fillRect(x, y, w, h, COLOR_LIGHTGRAY);
+    int16_t barW = w / SCHED_HIST_BUCKETS;
+    for (int b = 0; b < SCHED_HIST_BUCKETS; b++) {
+        uint32_t n = lat->buckets[b];
+        int16_t barH = 0;
+        while (n > 0 && barH < h - 1) {
+            n >>= 1;
+            barH++;
+        }
+        if (barH == 0) continue;
+        uint16_t color = ((1UL << b) >= SCHED_STALL_US) ? COLOR_RED : COLOR_BLUE;
+        draw_fillRect(x + b * barW + 1, y + h - barH, barW - 1, barH, color);
+    }
+}
+
+// Loop latency: longest task run, then a log2 histogram of run times
+static void gpsDebugDrawLoop(void)
+{
+    const SchedLatency *lat = sched_getLatency();
+    char loopText[48];
+    snprintf(loopText, sizeof(loopText), "Loop max %lums (%s) stalls %lu",
+             (unsigned long)(lat->maxUs / 1000), lat->maxTask ? lat->maxTask : "-",
+             (unsigned long)lat->stalls);
+    gpsDebugHeader(GPS_DBG_LOOP_Y, loopText);
+    drawLatencyHistogram(GPS_DBG_MARGIN, GPS_DBG_LOOP_Y + 17, GPS_DBG_W, 12, lat);
+    gpsDebug->lastLoopDraw = millis();
+}
+
+static bool screen_gps_debug_draw(uint8_t slice)
+{
+    (void)slice;
+    PERF_SCOPE(PERF_ZONE_GPS_DEBUG);
     SerialUSB.println(F("\n=== GPS Debug Screen Draw ==="));
     draw_fillRect(0, CONTENT_Y, SCREEN_WIDTH, CONTENT_HEIGHT, COLOR_BLACK);
-    
-    GPSData gpsData = gpsModule.getGPSData();
-    GPSDebugInfo debugInfo = gpsModule.getDebugInfo();
-    
-    const int16_t margin = 5;
-    int16_t yPos = CONTENT_Y + 5;
-    
-    draw_fillRect(margin, yPos, SCREEN_WIDTH - 2*margin, 20, COLOR_BLUE);
-    drawTruncatedText(margin + 5, yPos + 6, "GPS DEBUG INFO", SCREEN_WIDTH - 2*margin - 10, COLOR_BLUE);
-    yPos += 25;
-    
-    // Status
-    draw_fillRect(margin, yPos, SCREEN_WIDTH - 2*margin, 15, COLOR_DARKGRAY);
-    drawTruncatedText(margin + 3, yPos + 4, "Status:", SCREEN_WIDTH - 2*margin - 6, COLOR_DARKGRAY);
-    yPos += 17;
-    
-    char statusText[64];
-    if (gpsData.valid) snprintf(statusText, sizeof(statusText), "VALID FIX");
-    else snprintf(statusText, sizeof(statusText), "NO FIX");
-    
-    draw_fillRect(margin, yPos, SCREEN_WIDTH - 2*margin, 12, gpsData.valid ? COLOR_GREEN : COLOR_RED);
-    drawTruncatedText(margin + 3, yPos + 2, statusText, SCREEN_WIDTH - 2*margin - 6, gpsData.valid ? COLOR_GREEN : COLOR_RED);
-    yPos += 14;
-    
-    // Coordinates
-    draw_fillRect(margin, yPos, SCREEN_WIDTH - 2*margin, 15, COLOR_DARKGRAY);
-    drawTruncatedText(margin + 3, yPos + 4, "Coordinates:", SCREEN_WIDTH - 2*margin - 6, COLOR_DARKGRAY);
-    yPos += 17;
-    
-    char latText[32];
-    snprintf(latText, sizeof(latText), "Lat: %.6f", gpsData.latitude);
-    draw_fillRect(margin, yPos, SCREEN_WIDTH - 2*margin, 12, COLOR_LIGHTGRAY);
-    drawTruncatedText(margin + 3, yPos + 2, latText, SCREEN_WIDTH - 2*margin - 6, COLOR_LIGHTGRAY);
-    yPos += 14;
-    
-    char lonText[32];
-    snprintf(lonText, sizeof(lonText), "Lon: %.6f", gpsData.longitude);
-    draw_fillRect(margin, yPos, SCREEN_WIDTH - 2*margin, 12, COLOR_LIGHTGRAY);
-    drawTruncatedText(margin + 3, yPos + 2, lonText, SCREEN_WIDTH - 2*margin - 6, COLOR_LIGHTGRAY);
-    yPos += 14;
-    
-    // Commands
-    yPos += 3;
-    draw_fillRect(margin, yPos, SCREEN_WIDTH - 2*margin, 15, COLOR_DARKGRAY);
-    drawTruncatedText(margin + 3, yPos + 4, "Last AT Command:", SCREEN_WIDTH - 2*margin - 6, COLOR_DARKGRAY);
-    yPos += 17;
-    draw_fillRect(margin, yPos, SCREEN_WIDTH - 2*margin, 12, COLOR_YELLOW);
-    drawTruncatedText(margin + 3, yPos + 2, debugInfo.lastCommand, SCREEN_WIDTH - 2*margin - 6, COLOR_YELLOW);
-    yPos += 14;
-    
+
+    draw_fillRect(GPS_DBG_MARGIN, CONTENT_Y + 5, GPS_DBG_W, 20, COLOR_BLUE);
+    drawTruncatedText(GPS_DBG_MARGIN + 5, CONTENT_Y + 11, "GPS DEBUG INFO", GPS_DBG_W - 10, COLOR_BLUE);
+    gpsDebugHeader(GPS_DBG_CMD_Y - 17, "Last AT Command:");
+    gpsDebugHeader(GPS_DBG_NMEA_Y - 17, "Recent NMEA:");
+
+    // Live fields: note what is drawn, onUpdate redraws what changes
+    memset(gpsDebug->fixText, 0, sizeof(gpsDebug->fixText));
+    memset(gpsDebug->powerText, 0, sizeof(gpsDebug->powerText));
+    memset(gpsDebug->cmdText, 0, sizeof(gpsDebug->cmdText));
+    gpsDebug->seenFix = gpsModule.getSeq(GPS_SEQ_FIX);
+    gpsDebug->seenDebug = gpsModule.getSeq(GPS_SEQ_DEBUG);
+    gpsDebug->seenNmea = gpsModule.getSeq(GPS_SEQ_NMEA);
+    gpsDebug->seenPower = gpsModule.getSeq(GPS_SEQ_POWER);
+    gpsDebugDrawFix();
+    gpsDebugDrawPower();
+    gpsDebugDrawCommand();
+    gpsDebugDrawNmea();
+    gpsDebugDrawLoop();
+
     // Buttons
-    yPos = NAVBAR_Y - 45;
+    int16_t yPos = NAVBAR_Y - 45;
     draw_fillRect(10, yPos, 70, 35, COLOR_GREEN);
     draw_rect(10, yPos, 70, 35, COLOR_DARKGREEN);
     drawTruncatedText(20, yPos + 13, "REFRESH", 50, COLOR_GREEN);
@@ -260,15 +416,18 @@ void screen_gps_debug_draw(void)
     drawTruncatedText(178, yPos + 13, "CLEAR", 44, COLOR_RED);
     
     SerialUSB.println(F("=== GPS Debug Screen Complete ===\n"));
+    return false;
 }
 
-void screen_gps_debug_handleTouch(int16_t x, int16_t y)
+static void screen_gps_debug_handleEvent(const UIEvent *ev)
 {
+    if (ev->type != UI_EVENT_TAP) return;
+    int16_t x = ev->x;
+    int16_t y = ev->y;
     int16_t buttonY = NAVBAR_Y - 45;
     if (x >= 10 && x <= 80 && y >= buttonY && y <= buttonY + 35) {
         SerialUSB.println(F("GPS Debug: REFRESH clicked"));
-        gpsModule.refreshDebugInfo();
-        ui_requestRedraw();
+        gpsModule.refreshDebugInfo(); // Replies show up as they arrive
         return;
     }
     if (x >= 90 && x <= 160 && y >= buttonY && y <= buttonY + 35) {
@@ -278,21 +437,63 @@ void screen_gps_debug_handleTouch(int16_t x, int16_t y)
     }
     if (x >= 170 && x <= 230 && y >= buttonY && y <= buttonY + 35) {
         SerialUSB.println(F("GPS Debug: CLEAR clicked - restarting GPS"));
+        // Both power changes are queued AT commands; nothing waits here
         gpsModule.turnOffGPS();
-        delay(1000);
         gpsModule.turnOnGPS();
-        ui_requestRedraw();
         return;
     }
 }
 
-void screen_gps_debug_update(void)
+// Each group is redrawn only when its sequence number moved, and within
+// it only the rows whose text changed
+static void screen_gps_debug_update(void)
 {
-    static unsigned long lastRefresh = 0;
-    if (millis() - lastRefresh > 3000) {
-        if (ui_getCurrentScreen() == SCREEN_GPS_DEBUG) {
-            ui_requestRedraw();
-        }
-        lastRefresh = millis();
+    PERF_SCOPE(PERF_ZONE_GPS_DEBUG);
+    uint32_t seq = gpsModule.getSeq(GPS_SEQ_FIX);
+    if (seq != gpsDebug->seenFix) {
+        gpsDebug->seenFix = seq;
+        gpsDebugDrawFix();
+    }
+    seq = gpsModule.getSeq(GPS_SEQ_DEBUG);
+    if (seq != gpsDebug->seenDebug) {
+        gpsDebug->seenDebug = seq;
+        gpsDebugDrawCommand();
+    }
+    seq = gpsModule.getSeq(GPS_SEQ_NMEA);
+    if (seq != gpsDebug->seenNmea) {
+        gpsDebug->seenNmea = seq;
+        gpsDebugDrawNmea();
+    }
+    seq = gpsModule.getSeq(GPS_SEQ_POWER);
+    if (seq != gpsDebug->seenPower) {
+        gpsDebug->seenPower = seq;
+        gpsDebugDrawPower();
     }
-}
\ No newline at end of file
+    // Once a second: on time and the acquiring count move without a seq
+    if (millis() - gpsDebug->lastLoopDraw >= GPS_DEBUG_LOOP_MS) {
+        gpsDebugDrawLoop();
+        gpsDebugDrawPower();
+    }
+}
+
+static const UIPage page_gps_debug = {
+    screen_gps_debug_enter,      // onEnter
+    screen_gps_debug_exit,       // onExit
+    screen_gps_debug_update,     // onUpdate (periodic refresh)
+    screen_gps_debug_draw,       // onDraw
+    screen_gps_debug_handleEvent // onEvent
+};
+
+// ===================================
+// Page Registry
+// ===================================
+
+void screens_registerAll(void)
+{
+    ui_registerPage(SCREEN_HOME, &page_home);
+    ui_registerPage(SCREEN_FILES, &page_files);
+    ui_registerPage(SCREEN_AI, &page_ai);
+    ui_registerPage(SCREEN_SETTINGS, &page_settings);
+    ui_registerPage(SCREEN_INPUT, &page_input);
+    ui_registerPage(SCREEN_GPS_DEBUG, &page_gps_debug);
+}
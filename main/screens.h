@@ -4,12 +4,11 @@
 #include "pages/home/home_page.h"
 #include "pages/files/files_page.h"
 
-// Remaining screens are still in screens.cpp for now
-void screen_ai_draw(void);
-void screen_settings_draw(void);
-void screen_input_draw(void);
-void screen_gps_debug_draw(void);
-void screen_gps_debug_handleTouch(int16_t x, int16_t y);
-void screen_gps_debug_update(void);
+// AI, Settings, Input and GPS Debug pages live in screens.cpp
+
+/**
+ * @brief Register every page's lifecycle hooks with the UI engine
+ */
+void screens_registerAll(void);
 
 #endif
\ No newline at end of file
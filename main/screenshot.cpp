@@ -0,0 +1,221 @@
+/**
+ * @file screenshot.cpp
+ * @brief Screenshot Streaming Implementation
+ */
+
+#include "screenshot.h"
+#include "tft_driver.h"
+
+// ===================================
+// Capture State
+// ===================================
+
+#define SHOT_LITERAL_MAX 32 // Pixels buffered before a literal packet is sent
+#define SHOT_RUN_MAX 129
+#define SHOT_OUT_SIZE 64
+
+static bool active = false;
+static uint16_t nextY = 0;
+static uint16_t bandCount = 0;
+static uint32_t bytesSent = 0;
+
+// Frame output, flushed to SerialUSB whenever it fills
+static uint8_t out[SHOT_OUT_SIZE];
+static uint8_t outLen = 0;
+static uint16_t crc = 0;
+
+// RLE encoder
+static uint16_t runColor = 0;
+static uint8_t runLen = 0;
+static uint16_t literal[SHOT_LITERAL_MAX];
+static uint8_t literalLen = 0;
+
+// ===================================
+// Framing
+// ===================================
+
+static void shot_flush(void)
+{
+    if (outLen > 0)
+    {
+        SerialUSB.write(out, outLen);
+        bytesSent += outLen;
+        outLen = 0;
+    }
+}
+
+static void shot_raw(uint8_t b)
+{
+    out[outLen++] = b;
+    if (outLen >= SHOT_OUT_SIZE)
+    {
+        shot_flush();
+    }
+}
+
+// Byte covered by the CRC
+static void shot_byte(uint8_t b)
+{
+    crc ^= (uint16_t)b << 8;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    shot_raw(b);
+}
+
+static void shot_u16(uint16_t v)
+{
+    shot_byte(v & 0xFF);
+    shot_byte(v >> 8);
+}
+
+static void shot_beginFrame(char type)
+{
+    shot_raw('S');
+    shot_raw('H');
+    crc = 0xFFFF;
+    shot_byte((uint8_t)type);
+}
+
+static void shot_endFrame(void)
+{
+    uint16_t sum = crc;
+    shot_raw(sum & 0xFF);
+    shot_raw(sum >> 8);
+    shot_flush();
+}
+
+// ===================================
+// RLE Encoder
+// ===================================
+
+static void shot_emitLiteral(void)
+{
+    if (literalLen == 0)
+    {
+        return;
+    }
+    shot_byte(literalLen - 1);
+    for (uint8_t i = 0; i < literalLen; i++)
+    {
+        shot_u16(literal[i]);
+    }
+    literalLen = 0;
+}
+
+static void shot_addLiteral(uint16_t color)
+{
+    literal[literalLen++] = color;
+    if (literalLen >= SHOT_LITERAL_MAX)
+    {
+        shot_emitLiteral();
+    }
+}
+
+// Close the pending run: two or more become a run packet, one joins the literal
+static void shot_closeRun(void)
+{
+    if (runLen >= 2)
+    {
+        shot_emitLiteral();
+        shot_byte(0x80 | (runLen - 2));
+        shot_u16(runColor);
+    }
+    else if (runLen == 1)
+    {
+        shot_addLiteral(runColor);
+    }
+    runLen = 0;
+}
+
+static void shot_pixel(uint16_t color)
+{
+    if (runLen > 0 && color == runColor && runLen < SHOT_RUN_MAX)
+    {
+        runLen++;
+        return;
+    }
+    shot_closeRun();
+    runColor = color;
+    runLen = 1;
+}
+
+// ===================================
+// Public API
+// ===================================
+
+bool shot_start(void)
+{
+    if (active)
+    {
+        return false;
+    }
+
+    uint16_t top, height, line;
+    tft_getScroll(&top, &height, &line);
+
+    active = true;
+    nextY = 0;
+    bandCount = 0;
+    bytesSent = 0;
+
+    shot_beginFrame('H');
+    shot_u16(SCREEN_WIDTH);
+    shot_u16(SCREEN_HEIGHT);
+    shot_u16(SHOT_BAND_LINES);
+    shot_u16(top);
+    shot_u16(height);
+    shot_u16(line);
+    shot_endFrame();
+    return true;
+}
+
+void shot_poll(void)
+{
+    if (!active)
+    {
+        return;
+    }
+
+    uint16_t lines = SHOT_BAND_LINES;
+    if (nextY + lines > SCREEN_HEIGHT)
+    {
+        lines = SCREEN_HEIGHT - nextY;
+    }
+
+    shot_beginFrame('B');
+    shot_u16(nextY);
+    shot_u16(lines);
+
+    tft_beginRead(0, nextY, SCREEN_WIDTH - 1, nextY + lines - 1);
+    for (uint32_t i = 0; i < (uint32_t)SCREEN_WIDTH * lines; i++)
+    {
+        shot_pixel(tft_readColor());
+    }
+    tft_endRead();
+
+    shot_closeRun();
+    shot_emitLiteral();
+    shot_endFrame();
+
+    bandCount++;
+    nextY += lines;
+    if (nextY < SCREEN_HEIGHT)
+    {
+        return;
+    }
+
+    uint32_t total = bytesSent;
+    shot_beginFrame('E');
+    shot_u16(bandCount);
+    shot_u16(total & 0xFFFF);
+    shot_u16(total >> 16);
+    shot_endFrame();
+    active = false;
+}
+
+bool shot_busy(void)
+{
+    return active;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file screenshot.h
+ * @brief Screenshot Streaming over SerialUSB
+ *
+ * Reads the panel back band by band with RAMRD and streams it as RLE
+ * frames, one band per scheduler run, so a capture never holds the CPU
+ * for longer than one band (SHOT_BAND_LINES lines). tools/screenshot.py
+ * turns the stream into a PNG.
+ *
+ * Frame layout (all integers little-endian):
+ *   'S' 'H' type fields... crc16
+ *   type 'H': u16 width, u16 height, u16 bandLines,
+ *             u16 scrollTop, u16 scrollHeight, u16 scrollLine
+ *   type 'B': u16 y, u16 lines, RLE pixels (width * lines of them)
+ *   type 'E': u16 bands, u32 bytes (all frame bytes sent before 'E')
+ *
+ * RLE packets start with a control byte c: c < 0x80 is a literal of c + 1
+ * RGB565 pixels, c >= 0x80 is one pixel repeated (c & 0x7F) + 2 times.
+ * The CRC is CRC-16/CCITT-FALSE over the type byte and everything after it.
+ *
+ * Pixels come from display RAM, so the host tool applies the scroll
+ * values from the header. Pages keep drawing between bands; a capture
+ * taken during an animation may show it mid-way.
+ */
+
+#ifndef SCREENSHOT_H
+#define SCREENSHOT_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===================================
+// Screenshot Functions
+// ===================================
+
+/**
+ * @brief Start a capture (sends the header frame)
+ * @return false if a capture is already running
+ */
+bool shot_start(void);
+
+/**
+ * @brief Send the next band, run as a scheduler task every SHOT_BAND_MS
+ *
+ * Returns immediately when no capture is running.
+ */
+void shot_poll(void);
+
+/**
+ * @brief Check whether a capture is in progress
+ * @return true while bands remain
+ */
+bool shot_busy(void);
+
+#endif // SCREENSHOT_H
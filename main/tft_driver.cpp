@@ -7,6 +7,7 @@
  */
 
 #include "tft_driver.h"
+#include "perf.h"
 
 // ===================================
 // Bare Metal SPI (SERCOM1)
@@ -50,7 +51,7 @@ void spi_init(void)
     SERCOM1->SPI.CTRLB.reg = SERCOM_SPI_CTRLB_RXEN; // Enable receiver
 
     // 5. Set baud rate: 12 MHz SPI clock -> (48 / (2*12)) - 1 = 1
-    SERCOM1->SPI.BAUD.reg = 1;
+    SERCOM1->SPI.BAUD.reg = SPI_BAUD_WRITE;
 
     // 6. Enable SPI
     SERCOM1->SPI.CTRLA.bit.ENABLE = 1;
@@ -60,6 +61,7 @@ void spi_init(void)
 
 uint8_t spi_transfer(uint8_t data)
 {
+    PERF_COUNT(spiBytes, 1);
     while (SERCOM1->SPI.INTFLAG.bit.DRE == 0)
         ; // Wait for Data Register Empty
     SERCOM1->SPI.DATA.reg = data;
@@ -68,12 +70,25 @@ uint8_t spi_transfer(uint8_t data)
     return (uint8_t)SERCOM1->SPI.DATA.reg;
 }
 
+// BAUD is enable-protected, so the SERCOM is stopped around the change
+static void spi_setBaud(uint8_t baud)
+{
+    SERCOM1->SPI.CTRLA.bit.ENABLE = 0;
+    while (SERCOM1->SPI.SYNCBUSY.bit.ENABLE)
+        ;
+    SERCOM1->SPI.BAUD.reg = baud;
+    SERCOM1->SPI.CTRLA.bit.ENABLE = 1;
+    while (SERCOM1->SPI.SYNCBUSY.bit.ENABLE)
+        ;
+}
+
 // ===================================
 // TFT Low-Level Commands
 // ===================================
 
 void tft_writeCommand(uint8_t cmd)
 {
+    PERF_COUNT(commands, 1);
     CLR_PIN(TFT_DC_PORT, TFT_DC_PIN); // DC Low  = Command
     CLR_PIN(TFT_CS_PORT, TFT_CS_PIN); // CS Low
     spi_transfer(cmd);
@@ -103,6 +118,7 @@ void tft_writeData16(uint16_t data)
 
 void tft_setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
 {
+    PERF_COUNT(windows, 1);
     tft_writeCommand(ILI9341_CASET);
     tft_writeData16(x0);
     tft_writeData16(x1);
@@ -125,10 +141,88 @@ void tft_endWrite(void)
 
 void tft_writeColor(uint16_t color)
 {
+    PERF_COUNT(pixels, 1);
     spi_transfer(color >> 8);
     spi_transfer(color & 0xFF);
 }
 
+// ===================================
+// Memory Read-Back
+// ===================================
+
+void tft_beginRead(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    PERF_COUNT(windows, 1);
+    tft_writeCommand(ILI9341_CASET);
+    tft_writeData16(x0);
+    tft_writeData16(x1);
+    tft_writeCommand(ILI9341_PASET);
+    tft_writeData16(y0);
+    tft_writeData16(y1);
+
+    // RAMRD must stay in one CS-low transaction: raising CS ends the read
+    PERF_COUNT(commands, 1);
+    spi_setBaud(SPI_BAUD_READ);
+    CLR_PIN(TFT_DC_PORT, TFT_DC_PIN);
+    CLR_PIN(TFT_CS_PORT, TFT_CS_PIN);
+    spi_transfer(ILI9341_RAMRD);
+    SET_PIN(TFT_DC_PORT, TFT_DC_PIN);
+    spi_transfer(0x00); // Dummy read cycle
+}
+
+uint16_t tft_readColor(void)
+{
+    // Pixels come back as 18-bit RGB666, one left-aligned byte per channel
+    uint8_t r = spi_transfer(0x00);
+    uint8_t g = spi_transfer(0x00);
+    uint8_t b = spi_transfer(0x00);
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+void tft_endRead(void)
+{
+    SET_PIN(TFT_CS_PORT, TFT_CS_PIN);
+    spi_setBaud(SPI_BAUD_WRITE);
+}
+
+// ===================================
+// Hardware Scrolling
+// ===================================
+
+// Last values sent, the panel cannot report them back
+static uint16_t scrollTop = 0;
+static uint16_t scrollHeight = SCREEN_HEIGHT;
+static uint16_t scrollLine = 0;
+
+void tft_setScrollArea(uint16_t topFixed, uint16_t bottomFixed)
+{
+    scrollTop = topFixed;
+    scrollHeight = SCREEN_HEIGHT - topFixed - bottomFixed;
+    tft_writeCommand(ILI9341_VSCRDEF);
+    tft_writeData16(topFixed);
+    tft_writeData16(SCREEN_HEIGHT - topFixed - bottomFixed);
+    tft_writeData16(bottomFixed);
+}
+
+void tft_scrollTo(uint16_t line)
+{
+    scrollLine = line;
+    tft_writeCommand(ILI9341_VSCRSADD);
+    tft_writeData16(line);
+}
+
+void tft_setIdleMode(bool on)
+{
+    tft_writeCommand(on ? ILI9341_IDMON : ILI9341_IDMOFF);
+}
+
+void tft_getScroll(uint16_t *top, uint16_t *height, uint16_t *line)
+{
+    *top = scrollTop;
+    *height = scrollHeight;
+    *line = scrollLine;
+}
+
 // ===================================
 // Initialization
 // ===================================
@@ -140,6 +234,11 @@ void tft_init(void)
     PIN_OUTPUT(TFT_DC_PORT, TFT_DC_PIN);
     PIN_OUTPUT(TFT_RST_PORT, TFT_RST_PIN);
     PIN_OUTPUT(TOUCH_CS_PORT, TOUCH_CS_PIN);
+#if TOUCH_IRQ_WIRED
+    PIN_INPUT(TOUCH_IRQ_PORT, TOUCH_IRQ_PIN);
+    PORT->Group[TOUCH_IRQ_PORT].PINCFG[TOUCH_IRQ_PIN].reg = PORT_PINCFG_INEN | PORT_PINCFG_PULLEN;
+    SET_PIN(TOUCH_IRQ_PORT, TOUCH_IRQ_PIN); // Pull-up
+#endif
 
     // Set defaults: all CS high, RST high
     SET_PIN(TFT_CS_PORT, TFT_CS_PIN);
@@ -87,4 +87,60 @@ void tft_endWrite(void);
  */
 void tft_writeColor(uint16_t color);
 
+/**
+ * @brief Start reading display RAM back from a window (RAMRD)
+ *
+ * Drops the SPI clock to SPI_BAUD_READ and keeps CS low until
+ * tft_endRead(). Pixels are returned in the same order RAMWR writes them.
+ * @param x0 Start X coordinate
+ * @param y0 Start Y coordinate
+ * @param x1 End X coordinate
+ * @param y1 End Y coordinate
+ */
+void tft_beginRead(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+
+/**
+ * @brief Read the next pixel of the read window
+ * @return RGB565 color
+ */
+uint16_t tft_readColor(void);
+
+/**
+ * @brief End the read (CS=HIGH) and restore the write clock
+ */
+void tft_endRead(void);
+
+/**
+ * @brief Define the hardware vertical scroll area
+ *
+ * Lines between the two fixed areas form a ring in display RAM that
+ * tft_scrollTo() rotates without rewriting any pixels.
+ * @param topFixed Lines fixed at the top (not scrolled)
+ * @param bottomFixed Lines fixed at the bottom (not scrolled)
+ */
+void tft_setScrollArea(uint16_t topFixed, uint16_t bottomFixed);
+
+/**
+ * @brief Set the display RAM line shown at the top of the scroll area
+ * @param line RAM line, between topFixed and SCREEN_HEIGHT - bottomFixed - 1
+ */
+void tft_scrollTo(uint16_t line);
+
+/**
+ * @brief Switch the panel's idle mode (8 colors, lower power) on or off
+ * @param on true to enter idle mode
+ */
+void tft_setIdleMode(bool on);
+
+/**
+ * @brief Get the scroll setup last sent to the panel
+ *
+ * Display RAM read back with RAMRD is unscrolled; this is what maps it
+ * to what is actually on the glass.
+ * @param top Out: first line of the scroll area
+ * @param height Out: lines in the scroll area
+ * @param line Out: RAM line shown at the top of the scroll area
+ */
+void tft_getScroll(uint16_t *top, uint16_t *height, uint16_t *line);
+
 #endif // TFT_DRIVER_H
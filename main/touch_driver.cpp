@@ -27,6 +27,15 @@ uint16_t touch_readRaw(uint8_t cmd)
 // Touch Detection
 // ===================================
 
+bool touch_irqActive(void)
+{
+#if TOUCH_IRQ_WIRED
+    return READ_PIN(TOUCH_IRQ_PORT, TOUCH_IRQ_PIN) == 0;
+#else
+    return true; // Unknown without PENIRQ, callers must poll
+#endif
+}
+
 bool touch_isTouched(void)
 {
     // Read Z1 pressure to detect touch
@@ -41,6 +41,13 @@ bool touch_getRaw(uint16_t *x, uint16_t *y, uint16_t *z);
  */
 bool touch_getPoint(int16_t *x, int16_t *y);
 
+/**
+ * @brief Check the PENIRQ line without using the SPI bus
+ * @return true if the panel may be touched (always true when
+ *         TOUCH_IRQ_WIRED is 0)
+ */
+bool touch_irqActive(void);
+
 /**
  * @brief Check if screen is currently being touched (pressure-based)
  * @return true if touch detected
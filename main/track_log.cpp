@@ -0,0 +1,590 @@
+/**
+ * @file track_log.cpp
+ * @brief Append-Only Binary GPS Track Log Implementation
+ */
+
+#include "track_log.h"
+
+// Each group is TRACK_INDEX_SPAN data blocks followed by their index block
+#define TRACK_GROUP_BLOCKS (TRACK_INDEX_SPAN + 1)
+#define TRACK_INDEX_MAX ((TRACK_BLOCK_SIZE - 16) / 4) // Base times after the header
+
+#if TRACK_INDEX_SPAN > TRACK_INDEX_MAX || TRACK_INDEX_SPAN > 255
+#error "TRACK_INDEX_SPAN base times must fit in one index block"
+#endif
+
+// The block being filled; it is also where index blocks are assembled
+static uint8_t blockBuf[TRACK_BLOCK_SIZE] __attribute__((aligned(4)));
+static TrackBlockHeader *const blockHead = (TrackBlockHeader *)blockBuf;
+static uint8_t *const blockPayload = blockBuf + sizeof(TrackBlockHeader);
+
+static File trackFile;
+static bool trackOpen = false;
+static unsigned long openFailMs = 0;
+static bool openFailed = false;
+static uint32_t curBlock = 0;   // Block number of blockBuf in the file
+static uint16_t blockUsed = 0;  // Payload bytes in blockBuf
+static TrackPoint blockPrev;    // Point the next record is relative to
+static uint32_t indexTimes[TRACK_INDEX_SPAN]; // Base times of the current group
+static uint32_t lastTime = 0;   // Newest point stored
+static bool unsynced = false;   // Written or buffered since the last flush
+static unsigned long lastSyncMs = 0;
+static TrackStats trackStats;
+
+static inline bool track_isIndexSlot(uint32_t block)
+{
+    return block % TRACK_GROUP_BLOCKS == TRACK_INDEX_SPAN;
+}
+
+// ===================================
+// Record Codec
+// ===================================
+
+// Nearest 1e-6 degree step
+static int32_t track_grid(int32_t e7)
+{
+    return ((e7 >= 0) ? e7 + TRACK_DELTA_E7 / 2 : e7 - TRACK_DELTA_E7 / 2) / TRACK_DELTA_E7;
+}
+
+static uint8_t track_putVarint(uint8_t *out, uint32_t v)
+{
+    uint8_t n = 0;
+    while (v >= 0x80)
+    {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static uint8_t track_getVarint(const uint8_t *in, uint8_t len, uint32_t *v)
+{
+    uint32_t result = 0;
+    for (uint8_t n = 0; n < len && n < 5; n++)
+    {
+        result |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+        if ((in[n] & 0x80) == 0)
+        {
+            *v = result;
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+// Small magnitudes of either sign become small unsigned values
+static inline uint32_t track_zigzag(int32_t v)
+{
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t track_unzigzag(uint32_t v)
+{
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+uint8_t track_encodeRecord(uint8_t *out, const TrackPoint *prev, const TrackPoint *p)
+{
+    uint8_t n = track_putVarint(out, p->time - prev->time);
+    n += track_putVarint(out + n, track_zigzag(track_grid(p->latE7) - track_grid(prev->latE7)));
+    n += track_putVarint(out + n, track_zigzag(track_grid(p->lonE7) - track_grid(prev->lonE7)));
+    n += track_putVarint(out + n, track_zigzag((int32_t)p->altM - prev->altM));
+    return n;
+}
+
+uint8_t track_decodeRecord(const uint8_t *in, uint8_t len, TrackPoint *point)
+{
+    uint32_t v[4];
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        uint8_t used = track_getVarint(in + n, len - n, &v[i]);
+        if (used == 0)
+        {
+            return 0;
+        }
+        n += used;
+    }
+    point->time += v[0];
+    point->latE7 = (track_grid(point->latE7) + track_unzigzag(v[1])) * TRACK_DELTA_E7;
+    point->lonE7 = (track_grid(point->lonE7) + track_unzigzag(v[2])) * TRACK_DELTA_E7;
+    point->altM = (int16_t)(point->altM + track_unzigzag(v[3]));
+    return n;
+}
+
+// What the first record of a block is relative to
+static void track_basePoint(const TrackBlockHeader *h, TrackPoint *p)
+{
+    p->time = h->baseTime;
+    p->latE7 = h->baseLatE7;
+    p->lonE7 = h->baseLonE7;
+    p->altM = 0;
+}
+
+static bool track_blockFull(void)
+{
+    // A stationary point 1 s on needs 4 bytes; the count must fit uint8
+    return TRACK_BLOCK_PAYLOAD - blockUsed < 4 || blockHead->count == 255;
+}
+
+// Decode the block in blockBuf to find its end and newest point
+static bool track_loadRecords(void)
+{
+    if (blockHead->magic != TRACK_MAGIC || blockHead->type != TRACK_BLOCK_DATA ||
+        blockHead->count == 0)
+    {
+        return false;
+    }
+    track_basePoint(blockHead, &blockPrev);
+    blockUsed = 0;
+    for (uint8_t i = 0; i < blockHead->count; i++)
+    {
+        uint16_t room = TRACK_BLOCK_PAYLOAD - blockUsed;
+        uint8_t used = track_decodeRecord(blockPayload + blockUsed, (room > 255) ? 255 : room,
+                                          &blockPrev);
+        if (used == 0)
+        {
+            return false;
+        }
+        blockUsed += used;
+    }
+    return true;
+}
+
+// ===================================
+// Sector I/O
+// ===================================
+
+static bool track_readHeader(File &f, uint32_t block, TrackBlockHeader *h)
+{
+    return f.seek(block * TRACK_BLOCK_SIZE) &&
+           f.read(h, sizeof(TrackBlockHeader)) == (int)sizeof(TrackBlockHeader) &&
+           h->magic == TRACK_MAGIC;
+}
+
+static bool track_writeSector(uint32_t block)
+{
+    if (!trackFile.seek(block * TRACK_BLOCK_SIZE) ||
+        trackFile.write(blockBuf, TRACK_BLOCK_SIZE) != TRACK_BLOCK_SIZE)
+    {
+        // Reopening later recovers the position from the file itself
+        SerialUSB.println(F("Track log: write failed"));
+        trackFile.close();
+        trackOpen = false;
+        return false;
+    }
+    trackStats.sectorWrites++;
+    unsynced = true;
+    return true;
+}
+
+// Index block for the group ending before `block`
+static bool track_writeIndex(uint32_t block)
+{
+    memset(blockBuf, 0, TRACK_BLOCK_SIZE);
+    blockHead->magic = TRACK_MAGIC;
+    blockHead->type = TRACK_BLOCK_INDEX;
+    blockHead->count = TRACK_INDEX_SPAN;
+    blockHead->baseTime = indexTimes[0];
+    memcpy(blockBuf + sizeof(TrackBlockHeader), indexTimes, sizeof(indexTimes));
+    bool ok = track_writeSector(block);
+    memset(blockBuf, 0, TRACK_BLOCK_SIZE);
+    if (ok)
+    {
+        trackStats.indexBlocks++;
+    }
+    return ok;
+}
+
+// Write the full or abandoned block in blockBuf and start the next one
+static bool track_closeBlock(void)
+{
+    if (!track_writeSector(curBlock))
+    {
+        trackStats.dropped += blockHead->count;
+        return false;
+    }
+    trackStats.blocks++;
+    curBlock++;
+    blockUsed = 0;
+    memset(blockBuf, 0, TRACK_BLOCK_SIZE);
+    if (track_isIndexSlot(curBlock))
+    {
+        if (!track_writeIndex(curBlock))
+        {
+            return false;
+        }
+        curBlock++;
+    }
+    return true;
+}
+
+// ===================================
+// Open and Recovery
+// ===================================
+
+// Continue where the file ends: reload a partly filled last block, the
+// newest time and the base times of the group being written
+static bool track_recover(void)
+{
+    uint32_t blocks = trackFile.size() / TRACK_BLOCK_SIZE;
+    memset(blockBuf, 0, TRACK_BLOCK_SIZE);
+    blockUsed = 0;
+    curBlock = blocks;
+    lastTime = 0;
+    if (blocks == 0)
+    {
+        return true;
+    }
+
+    uint32_t last = blocks - 1;
+    if (track_isIndexSlot(last))
+    {
+        last--; // Group complete, its newest point is in the block before
+    }
+    if (!trackFile.seek(last * TRACK_BLOCK_SIZE) ||
+        trackFile.read(blockBuf, TRACK_BLOCK_SIZE) != TRACK_BLOCK_SIZE)
+    {
+        return false;
+    }
+    if (!track_loadRecords())
+    {
+        // Torn write; overwrite the block
+        memset(blockBuf, 0, TRACK_BLOCK_SIZE);
+        blockUsed = 0;
+        curBlock = last;
+    }
+    else
+    {
+        lastTime = blockPrev.time;
+        if (curBlock == last + 1 && !track_blockFull())
+        {
+            curBlock = last;
+        }
+        else
+        {
+            memset(blockBuf, 0, TRACK_BLOCK_SIZE);
+            blockUsed = 0;
+        }
+    }
+
+    uint32_t first = curBlock - curBlock % TRACK_GROUP_BLOCKS;
+    memset(indexTimes, 0, sizeof(indexTimes));
+    for (uint32_t b = first; b < curBlock; b++)
+    {
+        TrackBlockHeader h;
+        if (!track_readHeader(trackFile, b, &h))
+        {
+            return false;
+        }
+        indexTimes[b - first] = h.baseTime;
+    }
+    if (blockHead->count > 0)
+    {
+        // Continued block: track_append() only sets its slot for a new one
+        indexTimes[curBlock - first] = blockHead->baseTime;
+    }
+
+    // A crash between the last data block and its index
+    if (track_isIndexSlot(curBlock))
+    {
+        if (!track_writeIndex(curBlock))
+        {
+            return false;
+        }
+        curBlock++;
+    }
+    return true;
+}
+
+static bool track_ensureOpen(void)
+{
+    if (trackOpen)
+    {
+        return true;
+    }
+    // No card: retry at the sync rate rather than on every fix
+    if (openFailed && millis() - openFailMs < TRACK_SYNC_MS)
+    {
+        return false;
+    }
+
+    // Not FILE_WRITE, which appends every write at the end of the file
+    trackFile = SD.open(TRACK_FILE, O_READ | O_WRITE | O_CREAT);
+    if (!trackFile || !track_recover())
+    {
+        if (trackFile)
+        {
+            trackFile.close();
+        }
+        trackStats.openFails++;
+        openFailed = true;
+        openFailMs = millis();
+        return false;
+    }
+    trackOpen = true;
+    openFailed = false;
+    lastSyncMs = millis();
+    return true;
+}
+
+// ===================================
+// Writer
+// ===================================
+
+bool track_append(const TrackPoint *p)
+{
+    if (!track_ensureOpen() || p->time == 0 || p->time <= lastTime)
+    {
+        trackStats.dropped++;
+        return false;
+    }
+
+    uint8_t rec[TRACK_RECORD_MAX];
+    uint8_t len = 0;
+    if (blockHead->count > 0)
+    {
+        len = track_encodeRecord(rec, &blockPrev, p);
+        if (blockUsed + len > TRACK_BLOCK_PAYLOAD && !track_closeBlock())
+        {
+            trackStats.dropped++;
+            return false;
+        }
+    }
+    if (blockHead->count == 0)
+    {
+        blockHead->magic = TRACK_MAGIC;
+        blockHead->type = TRACK_BLOCK_DATA;
+        blockHead->baseTime = p->time;
+        blockHead->baseLatE7 = track_grid(p->latE7) * TRACK_DELTA_E7;
+        blockHead->baseLonE7 = track_grid(p->lonE7) * TRACK_DELTA_E7;
+        indexTimes[curBlock % TRACK_GROUP_BLOCKS] = p->time;
+        track_basePoint(blockHead, &blockPrev);
+        len = track_encodeRecord(rec, &blockPrev, p);
+    }
+
+    memcpy(blockPayload + blockUsed, rec, len);
+    blockUsed += len;
+    blockHead->count++;
+    blockPrev = *p;
+    lastTime = p->time;
+    unsynced = true;
+    trackStats.points++;
+
+    if (track_blockFull())
+    {
+        track_closeBlock();
+    }
+    if (millis() - lastSyncMs >= TRACK_SYNC_MS)
+    {
+        track_sync();
+    }
+    return true;
+}
+
+void track_sync(void)
+{
+    lastSyncMs = millis();
+    if (!trackOpen || !unsynced)
+    {
+        return;
+    }
+    if (blockHead->count > 0 && !track_writeSector(curBlock))
+    {
+        return;
+    }
+    trackFile.flush();
+    unsynced = false;
+    trackStats.syncs++;
+}
+
+void track_end(void)
+{
+    track_sync();
+    if (trackOpen)
+    {
+        trackFile.close();
+        trackOpen = false;
+    }
+}
+
+// ===================================
+// Reader
+// ===================================
+
+// First block that can hold `from`: the last data block whose base time is
+// not after it. Groups are found by a binary search on their first
+// headers, the block within a group from its index block.
+static uint32_t track_seek(TrackReader *r, uint32_t from)
+{
+    TrackBlockHeader h;
+    uint32_t groups = (r->blocks + TRACK_GROUP_BLOCKS - 1) / TRACK_GROUP_BLOCKS;
+    uint32_t lo = 0;
+    uint32_t hi = groups;
+    while (hi - lo > 1)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (track_readHeader(r->file, mid * TRACK_GROUP_BLOCKS, &h) && h.baseTime <= from)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    uint32_t first = lo * TRACK_GROUP_BLOCKS;
+    uint32_t index = first + TRACK_INDEX_SPAN;
+    if (index < r->blocks && track_readHeader(r->file, index, &h) && h.type == TRACK_BLOCK_INDEX)
+    {
+        uint32_t slot = 0;
+        for (uint8_t i = 0; i < h.count; i++)
+        {
+            uint32_t t;
+            if (r->file.read(&t, sizeof(t)) != (int)sizeof(t) || t > from)
+            {
+                break;
+            }
+            slot = i;
+        }
+        return first + slot;
+    }
+
+    // Group still being written, no index yet
+    lo = first;
+    hi = (index < r->blocks) ? index : r->blocks;
+    while (hi - lo > 1)
+    {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (track_readHeader(r->file, mid, &h) && h.baseTime <= from)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Load the header of r->block, leaving the file at its first record
+static bool track_loadBlock(TrackReader *r)
+{
+    if (track_isIndexSlot(r->block))
+    {
+        r->block++;
+    }
+    r->next = 0;
+    if (r->block >= r->blocks || !track_readHeader(r->file, r->block, &r->head) ||
+        r->head.type != TRACK_BLOCK_DATA)
+    {
+        return false;
+    }
+    track_basePoint(&r->head, &r->prev);
+    return true;
+}
+
+// Read one record byte by byte; varints end on a byte below 0x80
+static bool track_readRecord(TrackReader *r)
+{
+    uint8_t rec[TRACK_RECORD_MAX];
+    uint8_t n = 0;
+    for (uint8_t v = 0; v < 4; v++)
+    {
+        int c;
+        do
+        {
+            c = r->file.read();
+            if (c < 0 || n == TRACK_RECORD_MAX)
+            {
+                return false;
+            }
+            rec[n++] = (uint8_t)c;
+        } while (c & 0x80);
+    }
+    return track_decodeRecord(rec, n, &r->prev) == n;
+}
+
+bool track_openRange(TrackReader *r, uint32_t from, uint32_t until)
+{
+    track_sync();
+    r->file = SD.open(TRACK_FILE, FILE_READ);
+    if (!r->file)
+    {
+        return false;
+    }
+    r->blocks = r->file.size() / TRACK_BLOCK_SIZE;
+    r->from = from;
+    r->until = until;
+    r->block = (r->blocks > 0) ? track_seek(r, from) : 0;
+    if (!track_loadBlock(r))
+    {
+        r->block = r->blocks; // Empty or unreadable: nothing to return
+    }
+    return true;
+}
+
+bool track_next(TrackReader *r, TrackPoint *p)
+{
+    while (r->block < r->blocks)
+    {
+        if (r->next >= r->head.count)
+        {
+            r->block++;
+            if (!track_loadBlock(r))
+            {
+                r->block = r->blocks;
+                return false;
+            }
+            continue;
+        }
+
+        // Records are read in order, so the file position is already there
+        if (!track_readRecord(r))
+        {
+            r->block = r->blocks;
+            return false;
+        }
+        r->next++;
+        if (r->prev.time < r->from)
+        {
+            continue;
+        }
+        if (r->prev.time > r->until)
+        {
+            r->block = r->blocks;
+            return false;
+        }
+        *p = r->prev;
+        return true;
+    }
+    return false;
+}
+
+void track_close(TrackReader *r)
+{
+    r->file.close();
+}
+
+// ===================================
+// Statistics
+// ===================================
+
+const TrackStats *track_getStats(void)
+{
+    return &trackStats;
+}
+
+void track_printStats(void)
+{
+    char line[128];
+    snprintf(line, sizeof(line), "track pts=%lu blk=%lu idx=%lu wr=%lu sync=%lu drop=%lu fail=%lu",
+             (unsigned long)trackStats.points, (unsigned long)trackStats.blocks,
+             (unsigned long)trackStats.indexBlocks, (unsigned long)trackStats.sectorWrites,
+             (unsigned long)trackStats.syncs, (unsigned long)trackStats.dropped,
+             (unsigned long)trackStats.openFails);
+    SerialUSB.println(line);
+}
@@ -0,0 +1,156 @@
+/**
+ * @file track_log.h
+ * @brief Append-Only Binary GPS Track Log
+ *
+ * Points are stored in TRACK_FILE as 512-byte blocks, one SD sector each.
+ * A data block holds a 16-byte header with the absolute time and position
+ * of its first point, then one record per point: time, latitude,
+ * longitude and altitude as differences from the point before, as
+ * zig-zag varints. A walking track at one point every few seconds takes
+ * 4-6 bytes per point. After every
+ * TRACK_INDEX_SPAN data blocks comes an index block listing their base
+ * times, so a reader finds the block for any time with a handful of
+ * header reads instead of scanning the file.
+ *
+ * The block being filled lives in RAM and goes to the card as a whole
+ * sector when it is full. While points keep arriving, a partly filled
+ * block is rewritten in place every TRACK_SYNC_MS, so a power cut loses
+ * at most that much track.
+ */
+
+#ifndef TRACK_LOG_H
+#define TRACK_LOG_H
+
+#include <Arduino.h>
+#include <SD.h>
+#include "config.h"
+
+// ===================================
+// File Format
+// ===================================
+
+#define TRACK_BLOCK_SIZE 512
+#define TRACK_MAGIC 0x4B54 // "TK"
+#define TRACK_DELTA_E7 10  // Stored coordinates are in 1e-6 degree (11 cm)
+#define TRACK_RECORD_MAX 20 // Four varints of at most five bytes
+
+typedef enum
+{
+    TRACK_BLOCK_DATA = 1,
+    TRACK_BLOCK_INDEX = 2
+} TrackBlockType;
+
+typedef struct
+{
+    uint16_t magic;     // TRACK_MAGIC
+    uint8_t type;       // TrackBlockType
+    uint8_t count;      // Records, or data blocks listed by an index
+    uint32_t baseTime;  // First point, seconds since 2000-01-01 UTC
+    int32_t baseLatE7;  // First point of a data block, on the 1e-6 grid;
+    int32_t baseLonE7;  // its first record holds only the altitude
+} TrackBlockHeader;
+
+#define TRACK_BLOCK_PAYLOAD (TRACK_BLOCK_SIZE - sizeof(TrackBlockHeader))
+
+// ===================================
+// Track Types
+// ===================================
+
+typedef struct
+{
+    uint32_t time;      // Seconds since 2000-01-01 UTC (nmea_seconds)
+    int32_t latE7;
+    int32_t lonE7;
+    int16_t altM;
+} TrackPoint;
+
+typedef struct
+{
+    uint32_t points;        // Appended since boot
+    uint32_t blocks;        // Data blocks completed
+    uint32_t indexBlocks;
+    uint32_t sectorWrites;  // Including partial block rewrites
+    uint32_t syncs;
+    uint32_t dropped;       // No time, out of order, or no card
+    uint32_t openFails;
+} TrackStats;
+
+// Range cursor; records are decoded as they are read, so only the
+// header of the current block is held in RAM
+typedef struct
+{
+    File file;
+    uint32_t blocks;        // File length in blocks
+    uint32_t block;         // Current block
+    uint8_t next;           // Next record in it
+    TrackBlockHeader head;
+    TrackPoint prev;        // Point the next record is relative to
+    uint32_t from;
+    uint32_t until;
+} TrackReader;
+
+// ===================================
+// Track Functions
+// ===================================
+
+/**
+ * @brief Add a fix to the track
+ *
+ * Opens TRACK_FILE on first use and continues its last block. Points
+ * without a time, or not later than the previous one, are dropped.
+ * @return false if the point was dropped
+ */
+bool track_append(const TrackPoint *p);
+
+/**
+ * @brief Write the partly filled block and flush the file
+ */
+void track_sync(void);
+
+/**
+ * @brief Sync and close the file (card removal, shutdown)
+ *
+ * The next track_append() reopens it and continues the last block.
+ */
+void track_end(void);
+
+/**
+ * @brief Open a cursor on the points with from <= time <= until
+ *
+ * Syncs the writer first so the newest points are included.
+ * @return false if there is no track file
+ */
+bool track_openRange(TrackReader *r, uint32_t from, uint32_t until);
+
+/**
+ * @brief Next point of the range
+ * @return false at the end of the range
+ */
+bool track_next(TrackReader *r, TrackPoint *p);
+
+void track_close(TrackReader *r);
+
+/**
+ * @brief Encode a point as a record relative to the previous one
+ *
+ * Coordinates are rounded to the 1e-6 degree grid; decoding gives the
+ * rounded point, within 0.5e-6 degree of p.
+ * @param out At least TRACK_RECORD_MAX bytes
+ * @param prev Previous point (raw or decoded), zero for the first
+ * @return Bytes written
+ */
+uint8_t track_encodeRecord(uint8_t *out, const TrackPoint *prev, const TrackPoint *p);
+
+/**
+ * @brief Decode a record onto the previous point
+ * @param in Record bytes
+ * @param len Bytes available
+ * @param point Previous decoded point on entry, this one on return
+ * @return Bytes used, 0 if the record is cut off
+ */
+uint8_t track_decodeRecord(const uint8_t *in, uint8_t len, TrackPoint *point);
+
+const TrackStats *track_getStats(void);
+void track_printStats(void);
+
+#endif // TRACK_LOG_H
@@ -0,0 +1,98 @@
+/**
+ * @file track_simplify.cpp
+ * @brief Online Track Simplifier Implementation
+ */
+
+#include "track_simplify.h"
+
+// Whether p is within tol of the segment from the origin to b
+static bool track_nearSegment(const TrackOffset *p, const TrackOffset *b, int64_t tol)
+{
+    int64_t px = p->eastCm, py = p->northCm;
+    int64_t bx = b->eastCm, by = b->northCm;
+    int64_t dot = px * bx + py * by;
+    int64_t len2 = bx * bx + by * by;
+
+    // Beyond either end the nearest point is that end
+    if (dot <= 0)
+    {
+        return px * px + py * py <= tol * tol;
+    }
+    if (dot >= len2)
+    {
+        int64_t dx = px - bx, dy = py - by;
+        return dx * dx + dy * dy <= tol * tol;
+    }
+
+    // |p x b| / |b| is the distance from the line
+    int64_t cross = px * by - py * bx;
+    if (cross < 0)
+    {
+        cross = -cross;
+    }
+    return cross <= tol * (int64_t)geo_isqrt((uint64_t)len2);
+}
+
+static void track_keep(TrackSimplifier *s, const TrackPoint *p, TrackPoint *out)
+{
+    s->anchor = *p;
+    s->count = 0;
+    s->kept++;
+    *out = *p;
+}
+
+void track_simplifyInit(TrackSimplifier *s, uint16_t toleranceCm)
+{
+    memset(s, 0, sizeof(TrackSimplifier));
+    s->toleranceCm = (toleranceCm > TRACK_GRID_CM) ? toleranceCm - TRACK_GRID_CM : 0;
+}
+
+bool track_simplifyPush(TrackSimplifier *s, const TrackPoint *p, TrackPoint *out)
+{
+    if (!s->started)
+    {
+        s->started = true;
+        s->in++;
+        track_keep(s, p, out);
+        return true;
+    }
+    uint32_t newest = (s->count > 0) ? s->last.time : s->anchor.time;
+    if (p->time <= newest)
+    {
+        return false;
+    }
+    s->in++;
+
+    TrackOffset b;
+    geo_offsetCm(s->anchor.latE7, s->anchor.lonE7, p->latE7, p->lonE7, &b.eastCm, &b.northCm);
+
+    bool fits = s->count < TRACK_SIMPLIFY_WINDOW &&
+                p->time - s->anchor.time <= TRACK_SIMPLIFY_MAX_S;
+    for (uint8_t i = 0; fits && i < s->count; i++)
+    {
+        fits = track_nearSegment(&s->window[i], &b, s->toleranceCm);
+    }
+
+    bool kept = false;
+    if (!fits && s->count > 0)
+    {
+        // The segment to the previous fix covered the whole window
+        track_keep(s, &s->last, out);
+        geo_offsetCm(s->anchor.latE7, s->anchor.lonE7, p->latE7, p->lonE7,
+                     &b.eastCm, &b.northCm);
+        kept = true;
+    }
+    s->window[s->count++] = b;
+    s->last = *p;
+    return kept;
+}
+
+bool track_simplifyFlush(TrackSimplifier *s, TrackPoint *out)
+{
+    if (s->count == 0)
+    {
+        return false;
+    }
+    track_keep(s, &s->last, out);
+    return true;
+}
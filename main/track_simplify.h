@@ -0,0 +1,80 @@
+/**
+ * @file track_simplify.h
+ * @brief Online Track Simplifier with Bounded Error
+ *
+ * Opening-window line simplification run on each fix as it arrives. The
+ * last kept point anchors a window of following fixes; a new fix extends
+ * the window while every fix inside it lies within the tolerance of the
+ * straight segment from the anchor to the new one. When a fix breaks
+ * that, the previous one is kept and becomes the next anchor. Every
+ * dropped fix is therefore within the tolerance of the stored track,
+ * as with Douglas-Peucker, but decided one fix at a time. The track log
+ * stores kept points on its 1e-6 degree grid, which moves them by up to
+ * TRACK_GRID_CM, so segments are tested against that much less.
+ *
+ * Window fixes are kept only as offsets from the anchor, so the window
+ * costs 8 bytes per fix.
+ */
+
+#ifndef TRACK_SIMPLIFY_H
+#define TRACK_SIMPLIFY_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "geo.h"
+#include "track_log.h"
+
+// Most a kept point moves when stored: half a 1e-6 degree cell diagonal
+// (5.6 cm north and at most as much east), rounded up
+#define TRACK_GRID_CM 8
+
+// ===================================
+// Simplifier Types
+// ===================================
+
+typedef struct
+{
+    int32_t eastCm;
+    int32_t northCm;
+} TrackOffset;
+
+typedef struct
+{
+    TrackPoint anchor;      // Last kept point
+    TrackPoint last;        // Newest fix, kept if the next one breaks the window
+    TrackOffset window[TRACK_SIMPLIFY_WINDOW]; // Fixes after the anchor, relative to it
+    uint8_t count;          // Fixes in window, including last
+    bool started;
+    uint16_t toleranceCm;   // Less the grid allowance
+    uint32_t in;            // Fixes pushed
+    uint32_t kept;          // Points emitted
+} TrackSimplifier;
+
+// ===================================
+// Simplifier Functions
+// ===================================
+
+/**
+ * @brief Start a new track
+ * @param toleranceCm Largest distance of a dropped fix from the kept track
+ */
+void track_simplifyInit(TrackSimplifier *s, uint16_t toleranceCm);
+
+/**
+ * @brief Add the next fix
+ *
+ * The first fix is kept at once. Fixes not later than the previous one
+ * are ignored. A window that is full or spans TRACK_SIMPLIFY_MAX_S
+ * closes as if the fix had broken it.
+ * @param out Set to the point to store when true is returned
+ * @return true if a point was kept
+ */
+bool track_simplifyPush(TrackSimplifier *s, const TrackPoint *p, TrackPoint *out);
+
+/**
+ * @brief Keep the newest fix, ending the window (fix lost, shutdown)
+ * @return true if there was a fix to keep
+ */
+bool track_simplifyFlush(TrackSimplifier *s, TrackPoint *out);
+
+#endif // TRACK_SIMPLIFY_H
@@ -0,0 +1,221 @@
+/**
+ * @file uart_rx.cpp
+ * @brief DMA-Backed Receive Ring Implementation
+ */
+
+#include "uart_rx.h"
+
+#if (UART_RX_RING_SIZE & (UART_RX_RING_SIZE - 1)) != 0
+#error "UART_RX_RING_SIZE must be a power of two"
+#endif
+
+// Positions are free-running byte counts; the slot is count % size, and
+// head - tail is the fill level even across 32-bit wrap
+static uint8_t rxRing[UART_RX_RING_SIZE];
+static uint32_t rxTail = 0;      // Bytes consumed
+static uint32_t rxKnownHead = 0; // Producer position at the last check
+static UartRxStats rxStats;
+
+#ifdef ARDUINO_ARCH_SAMD
+
+// ===================================
+// DMA Producer (Serial1 = SERCOM0)
+// ===================================
+
+#define UART_DMA_CH 0
+
+static DmacDescriptor dmaDesc __attribute__((aligned(16)));
+static volatile DmacDescriptor dmaWriteBack __attribute__((aligned(16)));
+static volatile uint32_t rxLaps = 0; // Completed passes over the ring
+
+// The ring's single descriptor links to itself; each pass ends here
+extern "C" void DMAC_Handler(void)
+{
+    DMAC->CHID.reg = DMAC_CHID_ID(UART_DMA_CH);
+    if (DMAC->CHINTFLAG.bit.TCMPL)
+    {
+        DMAC->CHINTFLAG.reg = DMAC_CHINTFLAG_TCMPL;
+        rxLaps++;
+    }
+}
+
+// The core's Serial1 interrupt must stop taking bytes from DATA. It still
+// runs for transmit; a byte is moved by the DMA a few cycles after RXC
+// sets, long before that handler could get to it.
+static void uart_releaseRx(void)
+{
+    SERCOM0->USART.INTENCLR.reg = SERCOM_USART_INTENCLR_RXC;
+}
+
+static uint32_t uart_head(void)
+{
+    if (SERCOM0->USART.STATUS.bit.BUFOVF)
+    {
+        SERCOM0->USART.STATUS.reg = SERCOM_USART_STATUS_BUFOVF;
+        rxStats.hwOverruns++;
+    }
+
+    noInterrupts();
+    DMAC->CHID.reg = DMAC_CHID_ID(UART_DMA_CH);
+    uint32_t laps = rxLaps;
+
+    // Bytes left in this pass: live in ACTIVE while the channel is busy,
+    // otherwise in its write-back descriptor
+    uint32_t active = DMAC->ACTIVE.reg;
+    uint16_t left;
+    if ((active & DMAC_ACTIVE_ABUSY) &&
+        ((active & DMAC_ACTIVE_ID_Msk) >> DMAC_ACTIVE_ID_Pos) == UART_DMA_CH)
+    {
+        left = (uint16_t)(active >> DMAC_ACTIVE_BTCNT_Pos);
+    }
+    else
+    {
+        left = dmaWriteBack.BTCNT.reg;
+    }
+
+    // A pass ended and the descriptor reloaded, but DMAC_Handler has not
+    // counted it yet
+    if (DMAC->CHINTFLAG.bit.TCMPL && left != 0)
+    {
+        laps++;
+    }
+    interrupts();
+
+    return laps * UART_RX_RING_SIZE + (UART_RX_RING_SIZE - left);
+}
+
+void uart_begin(uint32_t baud)
+{
+    Serial1.begin(baud);
+    rxStats.baud = baud;
+
+    PM->AHBMASK.reg |= PM_AHBMASK_DMAC;
+    PM->APBBMASK.reg |= PM_APBBMASK_DMAC;
+    DMAC->CTRL.reg = 0;
+    DMAC->CTRL.reg = DMAC_CTRL_SWRST;
+    while (DMAC->CTRL.bit.SWRST)
+        ;
+    DMAC->BASEADDR.reg = (uint32_t)&dmaDesc;
+    DMAC->WRBADDR.reg = (uint32_t)&dmaWriteBack;
+    DMAC->CTRL.reg = DMAC_CTRL_DMAENABLE | DMAC_CTRL_LVLEN(0xF);
+
+    // One byte per RXC trigger, one block per pass over the ring
+    dmaDesc.BTCTRL.reg = DMAC_BTCTRL_VALID | DMAC_BTCTRL_BEATSIZE_BYTE |
+                         DMAC_BTCTRL_DSTINC | DMAC_BTCTRL_BLOCKACT_INT;
+    dmaDesc.BTCNT.reg = UART_RX_RING_SIZE;
+    dmaDesc.SRCADDR.reg = (uint32_t)&SERCOM0->USART.DATA.reg;
+    dmaDesc.DSTADDR.reg = (uint32_t)&rxRing[UART_RX_RING_SIZE]; // End address when incrementing
+    dmaDesc.DESCADDR.reg = (uint32_t)&dmaDesc;
+
+    DMAC->CHID.reg = DMAC_CHID_ID(UART_DMA_CH);
+    DMAC->CHCTRLA.reg = 0;
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_SWRST;
+    while (DMAC->CHCTRLA.bit.SWRST)
+        ;
+    DMAC->CHCTRLB.reg = DMAC_CHCTRLB_LVL(0) | DMAC_CHCTRLB_TRIGSRC(SERCOM0_DMAC_ID_RX) |
+                        DMAC_CHCTRLB_TRIGACT_BEAT;
+    DMAC->CHINTENSET.reg = DMAC_CHINTENSET_TCMPL;
+    NVIC_SetPriority(DMAC_IRQn, 1);
+    NVIC_EnableIRQ(DMAC_IRQn);
+    DMAC->CHCTRLA.reg = DMAC_CHCTRLA_ENABLE;
+
+    uart_releaseRx();
+}
+
+void uart_setBaud(uint32_t baud)
+{
+    // Let the last command finish at the old rate; begin() resets the
+    // SERCOM and turns its receive interrupt back on
+    Serial1.flush();
+    Serial1.begin(baud);
+    uart_releaseRx();
+    rxStats.baud = baud;
+}
+
+#else
+
+// ===================================
+// Simulator Producer
+// ===================================
+
+static uint32_t rxHead = 0;
+
+// The emulator releases bytes at the UART rate and never drops them;
+// copying whatever has arrived stands in for the DMA, so a loop stall
+// longer than the ring laps the consumer just as on the device
+static uint32_t uart_head(void)
+{
+    while (Serial1.available() > 0)
+    {
+        rxRing[rxHead % UART_RX_RING_SIZE] = (uint8_t)Serial1.read();
+        rxHead++;
+    }
+    return rxHead;
+}
+
+void uart_begin(uint32_t baud)
+{
+    Serial1.begin(baud);
+    rxStats.baud = baud;
+}
+
+void uart_setBaud(uint32_t baud)
+{
+    rxStats.baud = baud;
+}
+
+#endif
+
+// ===================================
+// Consumer
+// ===================================
+
+int uart_available(void)
+{
+    uint32_t head = uart_head();
+    uint32_t waiting = head - rxTail;
+
+    // Lapped: the oldest bytes are gone. Keep the newest half, which the
+    // DMA will not reach again for another half ring of time.
+    if (waiting >= UART_RX_RING_SIZE)
+    {
+        uint32_t keep = UART_RX_RING_SIZE / 2;
+        rxStats.overflows++;
+        rxStats.dropped += waiting - keep;
+        rxTail = head - keep;
+        waiting = keep;
+    }
+    if (waiting > rxStats.highWater)
+    {
+        rxStats.highWater = (uint16_t)waiting;
+    }
+    rxKnownHead = head;
+    return (int)waiting;
+}
+
+int uart_read(void)
+{
+    if (rxTail == rxKnownHead && uart_available() == 0)
+    {
+        return -1;
+    }
+    uint8_t c = rxRing[rxTail % UART_RX_RING_SIZE];
+    rxTail++;
+    rxStats.received++;
+    return c;
+}
+
+const UartRxStats *uart_getStats(void)
+{
+    return &rxStats;
+}
+
+void uart_printStats(void)
+{
+    char line[112];
+    snprintf(line, sizeof(line), "uart rx=%lu drop=%lu ovf=%lu hw=%lu high=%u/%u baud=%lu",
+             (unsigned long)rxStats.received, (unsigned long)rxStats.dropped,
+             (unsigned long)rxStats.overflows, (unsigned long)rxStats.hwOverruns,
+             rxStats.highWater, (unsigned)UART_RX_RING_SIZE, (unsigned long)rxStats.baud);
+    SerialUSB.println(line);
+}
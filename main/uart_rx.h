@@ -0,0 +1,75 @@
+/**
+ * @file uart_rx.h
+ * @brief DMA-Backed Receive Ring for the A9G Link (Serial1)
+ *
+ * The core's Serial1 keeps only a small receive buffer, filled one byte
+ * per interrupt, and it overflows whenever loop() is busy drawing or
+ * writing the SD card. Here DMAC channel 0 copies every byte from the
+ * SERCOM0 data register into a large circular ring on its own; the ring
+ * is single-producer (the DMA) single-consumer (the AT engine), so no
+ * locking is needed. The consumer detects when the DMA has lapped it and
+ * counts the lost bytes.
+ *
+ * Transmit still goes through Serial1. The simulator fills the ring from
+ * the A9G emulator instead of DMA.
+ */
+
+#ifndef UART_RX_H
+#define UART_RX_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===================================
+// Receive Statistics
+// ===================================
+typedef struct
+{
+    uint32_t received;   // Bytes handed to the consumer
+    uint32_t dropped;    // Bytes overwritten before they were read
+    uint32_t overflows;  // Times the DMA lapped the consumer
+    uint32_t hwOverruns; // SERCOM receive overruns (DMA too late)
+    uint16_t highWater;  // Most bytes waiting in the ring
+    uint32_t baud;
+} UartRxStats;
+
+// ===================================
+// Receive Ring Functions
+// ===================================
+
+/**
+ * @brief Start Serial1 and the DMA receive ring
+ * @param baud Baud rate
+ */
+void uart_begin(uint32_t baud);
+
+/**
+ * @brief Change the baud rate, keeping the ring and its contents
+ * @param baud New baud rate
+ */
+void uart_setBaud(uint32_t baud);
+
+/**
+ * @brief Bytes waiting in the ring
+ * @return Count (0 after an overflow has been discarded)
+ */
+int uart_available(void);
+
+/**
+ * @brief Take one byte from the ring
+ * @return Byte, or -1 if empty
+ */
+int uart_read(void);
+
+/**
+ * @brief Get receive statistics
+ * @return Pointer to statistics
+ */
+const UartRxStats *uart_getStats(void);
+
+/**
+ * @brief Print receive counters over SerialUSB
+ */
+void uart_printStats(void);
+
+#endif // UART_RX_H
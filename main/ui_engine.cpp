@@ -5,9 +5,11 @@
 
 #include "ui_engine.h"
 #include "drawing.h"
-#include "touch_driver.h"
+#include "tft_driver.h"
+#include "input.h"
 #include "screens.h"
 #include "icons.h"
+#include "perf.h"
 #include <string.h>
 
 // ===================================
@@ -21,6 +23,7 @@ static UIState uiState = {
     "",            // alertMsg
     0,             // alertTime
     true,          // needsFullRedraw
+    0,             // renderSlice
     true,          // needsNavbarRedraw
     -1,            // lastTouchX
     -1,            // lastTouchY
@@ -28,8 +31,8 @@ static UIState uiState = {
     0,             // gsmSignal
     0,             // batteryLevel
     false,         // gpsLock
-    0.0,           // gpsLatitude
-    0.0,           // gpsLongitude
+    0,             // gpsLatE7
+    0,             // gpsLonE7
     false          // gpsValid
 };
 
@@ -41,6 +44,43 @@ static int buttonCount = 0;
 static UIValue dataValues[MAX_VALUES];
 static int valueCount = 0;
 
+// Latest value per label, kept across screen switches
+static int16_t labelValues[LABEL_COUNT];
+
+// Page registry
+static const UIPage *pages[SCREEN_COUNT];
+
+// Page arena: one block overlaid by whichever page is visible
+static uint32_t pageArena[PAGE_ARENA_SIZE / 4];
+static uint16_t arenaUsed = 0;
+static uint16_t arenaPeak[SCREEN_COUNT];
+static bool arenaFailed = false; // An allocation of the entering page failed
+
+// Alerts waiting behind the visible one, highest priority first and
+// first-come within a priority
+static struct
+{
+    AlertType type;
+    char msg[MAX_ALERT_LEN];
+} alertQueue[ALERT_QUEUE_SIZE];
+static uint8_t alertQueueCount = 0;
+
+// Page pixels under the banner, put back when the last alert goes away
+static PixelRun alertRuns[ALERT_SAVE_RUNS];
+static SaveUnder alertSave = {0, CONTENT_Y, SCREEN_WIDTH, ALERT_HEIGHT,
+                              alertRuns, ALERT_SAVE_RUNS, 0, false};
+static bool alertOnScreen = false;
+
+// Panel idle mode after DISPLAY_IDLE_MS without input
+static bool displayIdle = false;
+static bool swallowGesture = false; // The touch that woke the panel
+static uint32_t lastInputMs = 0;
+
+// Background boot progress shown between the GPS and GSM indicators
+#define BOOT_STATUS_X 55
+#define BOOT_STATUS_W (SCREEN_WIDTH - 35 - BOOT_STATUS_X)
+static char bootStatus[BOOT_STATUS_LEN];
+
 // Language strings
 const char *labels_en[LABEL_COUNT] = {
     "Moisture", "Nitrogen", "Phosphorus", "Potassium",
@@ -55,6 +95,84 @@ UIState *ui_getState(void)
     return &uiState;
 }
 
+// ===================================
+// Page Registry
+// ===================================
+
+void ui_registerPage(ScreenID screen, const UIPage *page)
+{
+    if (screen < SCREEN_COUNT)
+    {
+        pages[screen] = page;
+    }
+}
+
+void *ui_pageAlloc(size_t size)
+{
+    size = (size + 3) & ~(size_t)3;
+    if (size > sizeof(pageArena) - arenaUsed)
+    {
+        SerialUSB.print(F("ERROR: page arena full, wanted "));
+        SerialUSB.println((int)size);
+        arenaFailed = true;
+        return NULL;
+    }
+
+    void *block = (uint8_t *)pageArena + arenaUsed;
+    memset(block, 0, size);
+    arenaUsed += size;
+    if (arenaUsed > arenaPeak[uiState.currentScreen])
+    {
+        arenaPeak[uiState.currentScreen] = arenaUsed;
+    }
+    return block;
+}
+
+size_t ui_pageAvailable(void)
+{
+    return sizeof(pageArena) - arenaUsed;
+}
+
+uint16_t ui_getArenaPeak(ScreenID screen)
+{
+    return (screen < SCREEN_COUNT) ? arenaPeak[screen] : 0;
+}
+
+static const UIPage *ui_currentPage(void)
+{
+    return pages[uiState.currentScreen];
+}
+
+// False when the page could not get its arena memory; its onEnter
+// returns early and leaves nothing for the other hooks to use
+static bool ui_enterPage(void)
+{
+    arenaUsed = 0;
+    arenaFailed = false;
+    const UIPage *page = ui_currentPage();
+    if (page != NULL && page->onEnter != NULL)
+    {
+        page->onEnter();
+    }
+    return !arenaFailed;
+}
+
+static void ui_exitPage(void)
+{
+    const UIPage *page = ui_currentPage();
+    if (page != NULL && page->onExit != NULL)
+    {
+        page->onExit();
+    }
+
+    SerialUSB.print(F("Page "));
+    SerialUSB.print((int)uiState.currentScreen);
+    SerialUSB.print(F(" arena peak: "));
+    SerialUSB.print(arenaPeak[uiState.currentScreen]);
+    SerialUSB.print(F(" / "));
+    SerialUSB.println(PAGE_ARENA_SIZE);
+}
+
 // ===================================
 // UI Engine Initialization
 // ===================================
@@ -66,7 +184,13 @@ void ui_init(void)
     uiState.alertType = UI_ALERT_NONE;
     uiState.alertMsg[0] = '\0';
     uiState.alertTime = 0;
+    alertQueueCount = 0;
+    alertOnScreen = false;
+    displayIdle = false;
+    swallowGesture = false;
+    lastInputMs = millis();
     uiState.needsFullRedraw = true;
+    uiState.renderSlice = 0;
     uiState.needsNavbarRedraw = true;
     uiState.lastTouchX = -1;
     uiState.lastTouchY = -1;
@@ -74,6 +198,11 @@ void ui_init(void)
 
     buttonCount = 0;
     valueCount = 0;
+
+    input_init();
+
+    screens_registerAll();
+    ui_enterPage();
 }
 
 // ===================================
@@ -133,25 +262,58 @@ int ui_getButtonCount(void)
 // Data Binding System
 // ===================================
 
-void ui_registerValue(LabelID id, int16_t x, int16_t y, int16_t initialValue)
+void ui_registerValue(LabelID id, int16_t x, int16_t y, int16_t w, int16_t h,
+                      const char *format, const GFXfont *font,
+                      uint16_t fgColor, uint16_t bgColor)
 {
-    if (valueCount >= MAX_VALUES)
+    if (id >= LABEL_COUNT)
     {
         return;
     }
 
-    dataValues[valueCount].id = id;
-    dataValues[valueCount].x = x;
-    dataValues[valueCount].y = y;
-    dataValues[valueCount].value = initialValue;
-    dataValues[valueCount].lastValue = initialValue;
-    dataValues[valueCount].needsRedraw = true;
+    // Rebind in place if the screen is redrawn without clearing values
+    UIValue *val = NULL;
+    for (int i = 0; i < valueCount; i++)
+    {
+        if (dataValues[i].id == id)
+        {
+            val = &dataValues[i];
+            break;
+        }
+    }
+    if (val == NULL)
+    {
+        if (valueCount >= MAX_VALUES)
+        {
+            return;
+        }
+        val = &dataValues[valueCount++];
+    }
 
-    valueCount++;
+    val->id = id;
+    val->x = x;
+    val->y = y;
+    val->w = w;
+    val->h = h;
+    val->format = format;
+    val->font = font;
+    val->fgColor = fgColor;
+    val->bgColor = bgColor;
+    val->value = labelValues[id];
+    val->lastValue = labelValues[id];
+    val->text[0] = '\0'; // Caller just painted the box, nothing on screen yet
+    val->textX = x;
+    val->needsRedraw = true;
 }
 
 void ui_updateValue(LabelID id, int16_t newValue)
 {
+    if (id >= LABEL_COUNT)
+    {
+        return;
+    }
+    labelValues[id] = newValue;
+
     for (int i = 0; i < valueCount; i++)
     {
         if (dataValues[i].id == id && dataValues[i].value != newValue)
@@ -163,16 +325,121 @@ void ui_updateValue(LabelID id, int16_t newValue)
     }
 }
 
+int16_t ui_getValue(LabelID id)
+{
+    if (id >= LABEL_COUNT)
+    {
+        return 0;
+    }
+    return labelValues[id];
+}
+
+// Digits share one cell width so a changing digit never shifts its neighbours
+static int16_t ui_valueCellWidth(char c, const GFXfont *font, int16_t digitW)
+{
+    if (c >= '0' && c <= '9')
+    {
+        return digitW;
+    }
+    return get_GFXcharCellWidth(c, font);
+}
+
+static int16_t ui_valueTextWidth(const char *text, const GFXfont *font, int16_t digitW)
+{
+    int16_t w = 0;
+    while (*text)
+    {
+        w += ui_valueCellWidth(*text++, font, digitW);
+    }
+    return w;
+}
+
+static void ui_drawValue(UIValue *val)
+{
+    char newText[MAX_VALUE_TEXT_LEN];
+    snprintf(newText, sizeof(newText), val->format, val->value);
+
+    // Widest digit cell of this font
+    int16_t digitW = 0;
+    for (char c = '0'; c <= '9'; c++)
+    {
+        int16_t cw = get_GFXcharCellWidth(c, val->font);
+        if (cw > digitW)
+        {
+            digitW = cw;
+        }
+    }
+
+    int16_t cellH = pgm_read_byte(&val->font->yAdvance);
+    int16_t cellY = val->y + (val->h - cellH) / 2;
+
+    int16_t oldW = ui_valueTextWidth(val->text, val->font, digitW);
+    int16_t newW = ui_valueTextWidth(newText, val->font, digitW);
+    if (newW > val->w)
+    {
+        newW = val->w;
+    }
+    int16_t oldX = val->textX;
+    int16_t newX = val->x + (val->w - newW) / 2;
+
+    // Glyph-level diff: repaint a cell only if its char or position moved
+    int16_t ox = oldX;
+    int16_t nx = newX;
+    bool oldEnded = false;
+    for (int i = 0; newText[i] != '\0'; i++)
+    {
+        int16_t cw = ui_valueCellWidth(newText[i], val->font, digitW);
+        if (nx + cw > val->x + val->w)
+        {
+            newText[i] = '\0'; // Keep only what fits in the box
+            break;
+        }
+
+        bool same = false;
+        if (!oldEnded && val->text[i] != '\0')
+        {
+            same = (val->text[i] == newText[i] && ox == nx);
+            ox += ui_valueCellWidth(val->text[i], val->font, digitW);
+        }
+        else
+        {
+            oldEnded = true;
+        }
+
+        if (!same)
+        {
+            draw_GFXcharCell(nx, cellY, cw, cellH, newText[i], val->font,
+                             val->fgColor, val->bgColor);
+        }
+        nx += cw;
+    }
+
+    // Clear whatever the old text covered outside the new span
+    if (oldW > 0)
+    {
+        if (oldX < newX)
+        {
+            draw_fillRect(oldX, cellY, newX - oldX, cellH, val->bgColor);
+        }
+        if (oldX + oldW > nx)
+        {
+            draw_fillRect(nx, cellY, oldX + oldW - nx, cellH, val->bgColor);
+        }
+    }
+
+    strncpy(val->text, newText, MAX_VALUE_TEXT_LEN - 1);
+    val->text[MAX_VALUE_TEXT_LEN - 1] = '\0';
+    val->textX = newX;
+}
+
 void ui_redrawValues(void)
 {
     for (int i = 0; i < valueCount; i++)
     {
         if (dataValues[i].needsRedraw)
         {
-            // Clear and redraw value area
-            draw_fillRect(dataValues[i].x, dataValues[i].y, 80, 25, COLOR_LIGHTGRAY);
+            ui_drawValue(&dataValues[i]);
             dataValues[i].needsRedraw = false;
-            // Note: Actual number rendering would require a font library
         }
     }
 }
@@ -186,6 +453,91 @@ void ui_clearValues(void)
 // Alert System
 // ===================================
 
+// Centered in the box, clipped to whole glyph cells that fit its width
+static void ui_drawCenteredText(int16_t x0, int16_t y0, int16_t w, int16_t h,
+                                const char *text, uint16_t color, uint16_t bg)
+{
+    int16_t cellH = pgm_read_byte(&MyFontPro.yAdvance);
+    int16_t textW = 0;
+    int len = 0;
+    while (text[len] != '\0')
+    {
+        int16_t cw = get_GFXcharCellWidth(text[len], &MyFontPro);
+        if (textW + cw > w)
+        {
+            break;
+        }
+        textW += cw;
+        len++;
+    }
+
+    int16_t x = x0 + (w - textW) / 2;
+    int16_t y = y0 + (h - cellH) / 2;
+    for (int i = 0; i < len; i++)
+    {
+        int16_t cw = get_GFXcharCellWidth(text[i], &MyFontPro);
+        draw_GFXcharCell(x, y, cw, cellH, text[i], &MyFontPro, color, bg);
+        x += cw;
+    }
+}
+
+static void ui_queueAlert(const char *msg, AlertType type)
+{
+    if (alertQueueCount >= ALERT_QUEUE_SIZE)
+    {
+        // Full: the newcomer only gets in by pushing out a lower priority
+        if (type <= alertQueue[ALERT_QUEUE_SIZE - 1].type)
+        {
+            SerialUSB.println(F("Alert queue full, dropped"));
+            return;
+        }
+        alertQueueCount--;
+    }
+
+    uint8_t pos = alertQueueCount;
+    while (pos > 0 && alertQueue[pos - 1].type < type)
+    {
+        alertQueue[pos] = alertQueue[pos - 1];
+        pos--;
+    }
+    alertQueue[pos].type = type;
+    strncpy(alertQueue[pos].msg, msg, MAX_ALERT_LEN - 1);
+    alertQueue[pos].msg[MAX_ALERT_LEN - 1] = '\0';
+    alertQueueCount++;
+}
+
+// Put the current alert on the panel, saving the page under it first
+static void ui_placeAlert(void)
+{
+    if (!alertOnScreen)
+    {
+        if (!draw_saveUnder(&alertSave, 0, CONTENT_Y, SCREEN_WIDTH, ALERT_HEIGHT))
+        {
+            SerialUSB.println(F("Alert save-under overflow, page will redraw"));
+        }
+        alertOnScreen = true;
+    }
+    ui_drawAlert(uiState.alertMsg, uiState.alertType);
+}
+
+static void ui_presentAlert(const char *msg, AlertType type)
+{
+    if (msg != uiState.alertMsg)
+    {
+        strncpy(uiState.alertMsg, msg, MAX_ALERT_LEN - 1);
+        uiState.alertMsg[MAX_ALERT_LEN - 1] = '\0';
+    }
+    uiState.alertType = type;
+    uiState.alertTime = millis();
+
+    // A half-drawn page would be saved as-is; ui_drawScreen() places the
+    // alert once the page is complete instead
+    if (!uiState.needsFullRedraw)
+    {
+        ui_placeAlert();
+    }
+}
+
 void ui_drawAlert(const char *text, AlertType type)
 {
     if (type == UI_ALERT_NONE)
@@ -207,28 +559,65 @@ void ui_drawAlert(const char *text, AlertType type)
         break;
     }
 
-    draw_fillRect(0, CONTENT_Y, SCREEN_WIDTH, 30, color);
-    draw_fillRect(2, CONTENT_Y + 2, SCREEN_WIDTH - 4, 26, COLOR_BLACK);
-    // Note: Text rendering would require a font library
+    draw_fillRect(0, CONTENT_Y, SCREEN_WIDTH, ALERT_HEIGHT, color);
+    draw_fillRect(2, CONTENT_Y + 2, SCREEN_WIDTH - 4, ALERT_HEIGHT - 4, COLOR_BLACK);
+    ui_drawCenteredText(6, CONTENT_Y, SCREEN_WIDTH - 12, ALERT_HEIGHT, text, color, COLOR_BLACK);
 }
 
 void ui_showAlert(const char *msg, AlertType type)
 {
-    strncpy(uiState.alertMsg, msg, MAX_ALERT_LEN - 1);
-    uiState.alertMsg[MAX_ALERT_LEN - 1] = '\0';
-    uiState.alertType = type;
-    uiState.alertTime = millis();
-    ui_drawAlert(msg, type);
+    if (type == UI_ALERT_NONE)
+    {
+        return;
+    }
+    if (uiState.alertType == UI_ALERT_NONE)
+    {
+        ui_presentAlert(msg, type);
+        return;
+    }
+
+    // A more urgent alert takes the banner now; the one it displaced
+    // goes back in the queue and gets its full time later
+    if (type > uiState.alertType)
+    {
+        ui_queueAlert(uiState.alertMsg, uiState.alertType);
+        ui_presentAlert(msg, type);
+    }
+    else
+    {
+        ui_queueAlert(msg, type);
+    }
 }
 
 void ui_hideAlert(void)
 {
-    if (uiState.alertType != UI_ALERT_NONE &&
-        millis() - uiState.alertTime > ALERT_TIMEOUT_MS)
+    if (uiState.alertType == UI_ALERT_NONE ||
+        millis() - uiState.alertTime <= ALERT_TIMEOUT_MS)
+    {
+        return;
+    }
+
+    // Next queued alert reuses the banner and the pixels already saved
+    if (alertQueueCount > 0)
+    {
+        char msg[MAX_ALERT_LEN];
+        AlertType type = alertQueue[0].type;
+        strcpy(msg, alertQueue[0].msg);
+        alertQueueCount--;
+        memmove(&alertQueue[0], &alertQueue[1], alertQueueCount * sizeof(alertQueue[0]));
+        ui_presentAlert(msg, type);
+        return;
+    }
+
+    // During a page render the banner area is repainted anyway
+    uiState.alertType = UI_ALERT_NONE;
+    if (alertOnScreen && !uiState.needsFullRedraw)
     {
-        uiState.alertType = UI_ALERT_NONE;
-        // Only clear the alert area, not redraw the whole screen
-        draw_fillRect(0, CONTENT_Y, SCREEN_WIDTH, 30, COLOR_WHITE);
+        alertOnScreen = false;
+        if (!draw_restoreUnder(&alertSave))
+        {
+            ui_requestRedraw();
+        }
     }
 }
 
@@ -274,7 +663,10 @@ void ui_setScreen(ScreenID screen)
         return;
     }
 
+    ui_exitPage();
+
     ScreenID oldScreen = uiState.currentScreen;
+    ScreenID oldLast = uiState.lastScreen;
     uiState.lastScreen = uiState.currentScreen;
     uiState.currentScreen = screen;
 
@@ -288,12 +680,24 @@ void ui_setScreen(ScreenID screen)
         uiState.needsNavbarRedraw = true;
     }
 
-    // Trigger content area redraw
+    // Trigger content area redraw, abandoning any half-drawn page
     uiState.needsFullRedraw = true;
+    uiState.renderSlice = 0;
 
     // Clear screen-specific data
     ui_clearValues();
     ui_clearButtons();
+
+    // A page without its memory is left again for the one that was working
+    static bool fallingBack = false;
+    if (!ui_enterPage() && !fallingBack)
+    {
+        fallingBack = true;
+        ui_setScreen(oldScreen);
+        uiState.lastScreen = oldLast; // Back still leads where it did
+        fallingBack = false;
+        ui_showAlert("Out of page memory", UI_ALERT_ERROR);
+    }
 }
 
 ScreenID ui_getCurrentScreen(void)
@@ -314,6 +718,7 @@ void ui_goBack(void)
 void ui_requestRedraw(void)
 {
     uiState.needsFullRedraw = true;
+    uiState.renderSlice = 0;
 }
 
 // ===================================
@@ -334,7 +739,11 @@ void ui_drawHeader(const char *title)
     // GSM signal (right side)
     draw_gsmSignal(SCREEN_WIDTH - 30, 8, uiState.gsmSignal);
 
-    // Note: Title text rendering would require a font library
+    if (bootStatus[0] != '\0')
+    {
+        ui_drawCenteredText(BOOT_STATUS_X, 0, BOOT_STATUS_W, HEADER_HEIGHT,
+                            bootStatus, COLOR_WHITE, COLOR_BLUE);
+    }
 }
 
 void ui_drawStatus(void)
@@ -379,44 +788,60 @@ void ui_drawFooter(void)
     uiState.needsNavbarRedraw = false;
 }
 
+// Draw one slice of the current page; returns true while more remain.
+// Slice 0 is the header, the rest belong to the screen.
+static bool ui_drawSlice(uint8_t slice)
+{
+    if (slice == 0)
+    {
+        ui_drawHeader("Farm Monitor");
+        ui_drawStatus();
+        return true;
+    }
+
+    const UIPage *page = ui_currentPage();
+    if (page == NULL || page->onDraw == NULL)
+    {
+        return false;
+    }
+    return page->onDraw(slice - 1);
+}
+
 void ui_drawScreen(void)
 {
     if (!uiState.needsFullRedraw)
     {
         return;
     }
+    PERF_SCOPE(PERF_ZONE_DRAW_SCREEN);
 
-    // Draw header and status only on full redraw
-    ui_drawHeader("Farm Monitor");
-    ui_drawStatus();
-
-    // Draw screen content based on current screen
-    switch (uiState.currentScreen)
+    // Draw slices until the frame budget is spent or a touch arrives, then
+    // resume on the next ui_update() so input is dispatched in between
+    uint32_t start = micros();
+    while (ui_drawSlice(uiState.renderSlice++))
     {
-    case SCREEN_HOME:
-        screen_home_draw();
-        break;
-    case SCREEN_FILES:
-        screen_files_draw();
-        break;
-    case SCREEN_AI:
-        screen_ai_draw();
-        break;
-    case SCREEN_SETTINGS:
-        screen_settings_draw();
-        break;
-    case SCREEN_INPUT:
-        screen_input_draw();
-        break;
-    case SCREEN_GPS_DEBUG:
-        screen_gps_debug_draw();
-        break;
-    default:
-        break;
+        if ((uint32_t)(micros() - start) >= RENDER_BUDGET_US)
+        {
+            return;
+        }
+        input_poll();
+        if (input_pending())
+        {
+            return;
+        }
     }
 
     ui_drawFooter();
     uiState.needsFullRedraw = false;
+    uiState.renderSlice = 0;
+
+    // The page painted over any banner, so save the new pixels under it
+    alertOnScreen = false;
+    alertSave.valid = false;
+    if (uiState.alertType != UI_ALERT_NONE)
+    {
+        ui_placeAlert();
+    }
 }
 
 // ===================================
@@ -456,10 +881,32 @@ void ui_setGPS(bool locked)
     }
 }
 
-void ui_setGPSCoordinates(float lat, float lon, bool valid)
+void ui_setBootStatus(const char *text)
 {
-    uiState.gpsLatitude = lat;
-    uiState.gpsLongitude = lon;
+    if (text == NULL)
+    {
+        text = "";
+    }
+    if (strcmp(bootStatus, text) == 0)
+    {
+        return;
+    }
+    strncpy(bootStatus, text, BOOT_STATUS_LEN - 1);
+    bootStatus[BOOT_STATUS_LEN - 1] = '\0';
+
+    // Only redraw the status area within the header
+    draw_fillRect(BOOT_STATUS_X, 0, BOOT_STATUS_W, HEADER_HEIGHT, COLOR_BLUE);
+    if (bootStatus[0] != '\0')
+    {
+        ui_drawCenteredText(BOOT_STATUS_X, 0, BOOT_STATUS_W, HEADER_HEIGHT,
+                            bootStatus, COLOR_WHITE, COLOR_BLUE);
+    }
+}
+
+void ui_setGPSCoordinates(int32_t latE7, int32_t lonE7, bool valid)
+{
+    uiState.gpsLatE7 = latE7;
+    uiState.gpsLonE7 = lonE7;
     uiState.gpsValid = valid;
     
     // Update GPS lock status based on validity
@@ -491,48 +938,58 @@ void ui_handleHeader(int16_t x, int16_t y)
     }
 }
 
-void ui_handleTouch(int16_t x, int16_t y)
+void ui_handleEvent(const UIEvent *ev)
 {
-    // Debounce
-    if (millis() - uiState.lastTouchTime < TOUCH_DEBOUNCE_MS)
+    if (ev->type == UI_EVENT_TAP || ev->type == UI_EVENT_DRAG_START)
     {
-        return;
+        uiState.lastTouchTime = millis();
+        uiState.lastTouchX = ev->x;
+        uiState.lastTouchY = ev->y;
     }
-    uiState.lastTouchTime = millis();
-    uiState.lastTouchX = x;
-    uiState.lastTouchY = y;
 
-    // Check header first (for GPS debug)
-    if (y < HEADER_HEIGHT)
+    // Header and navbar only react to taps that started on them
+    if (ev->startY < HEADER_HEIGHT)
     {
-        ui_handleHeader(x, y);
+        if (ev->type == UI_EVENT_TAP)
+        {
+            ui_handleHeader(ev->x, ev->y);
+        }
         return;
     }
 
-    // Check navbar
-    if (y >= NAVBAR_Y)
+    if (ev->startY >= NAVBAR_Y)
     {
-        ui_handleNavbar(x, y);
+        if (ev->type == UI_EVENT_TAP)
+        {
+            ui_handleNavbar(ev->x, ev->y);
+        }
         return;
     }
 
-    // Screen-specific touch handling
-    if (uiState.currentScreen == SCREEN_FILES)
+    // Content gestures during a page render target whatever is half-drawn
+    // on the panel, so they are dropped; navbar and header taps above
+    // still switch pages immediately and restart the render
+    if (uiState.needsFullRedraw)
     {
-        screen_files_handleTouch(x, y);
         return;
     }
-    
-    if (uiState.currentScreen == SCREEN_GPS_DEBUG)
+
+    // Pages with their own gesture handling
+    const UIPage *page = ui_currentPage();
+    if (page != NULL && page->onEvent != NULL)
     {
-        screen_gps_debug_handleTouch(x, y);
+        page->onEvent(ev);
         return;
     }
 
     // Check buttons for other screens
+    if (ev->type != UI_EVENT_TAP)
+    {
+        return;
+    }
     for (int i = 0; i < buttonCount; i++)
     {
-        if (ui_checkButton(&buttons[i], x, y))
+        if (ui_checkButton(&buttons[i], ev->x, ev->y))
         {
             if (buttons[i].callback != NULL)
             {
@@ -541,8 +998,26 @@ void ui_handleTouch(int16_t x, int16_t y)
             return;
         }
     }
+}
+
+// ===================================
+// Display Idle Mode
+// ===================================
 
-    // Screen-specific touch handling could be added here for other screens
+static void ui_setDisplayIdle(bool idle)
+{
+    if (idle == displayIdle)
+    {
+        return;
+    }
+    displayIdle = idle;
+    tft_setIdleMode(idle);
+    SerialUSB.println(idle ? F("Display idle") : F("Display awake"));
+}
+
+bool ui_isDisplayIdle(void)
+{
+    return displayIdle;
 }
 
 // ===================================
@@ -551,19 +1026,52 @@ void ui_handleTouch(int16_t x, int16_t y)
 
 void ui_update(void)
 {
-    // Handle touch input
-    int16_t x, y;
-    if (touch_getPoint(&x, &y))
+    // Sample touch and dispatch any recognized gestures
+    input_poll();
+    if (displayIdle && (input_isTouching() || input_pending()))
+    {
+        // Waking the panel is all this touch does
+        ui_setDisplayIdle(false);
+        swallowGesture = true;
+    }
+    UIEvent ev;
+    while (input_nextEvent(&ev))
+    {
+        lastInputMs = millis();
+        if (!swallowGesture)
+        {
+            ui_handleEvent(&ev);
+        }
+        input_recordLatency(&ev);
+    }
+    if (swallowGesture && !input_isTouching() && !input_pending())
     {
-        ui_handleTouch(x, y);
+        swallowGesture = false;
+    }
+    if (input_isTouching())
+    {
+        lastInputMs = millis();
+    }
+    if (!displayIdle && millis() - lastInputMs > DISPLAY_IDLE_MS)
+    {
+        ui_setDisplayIdle(true);
     }
 
     // Update screen if needed
     ui_drawScreen();
 
+    // Per-frame page work, once the page is fully drawn
+    const UIPage *page = ui_currentPage();
+    if (page != NULL && page->onUpdate != NULL && !uiState.needsFullRedraw)
+    {
+        page->onUpdate();
+    }
+
     // Update dynamic values
     ui_redrawValues();
 
     // Hide alert after timeout
     ui_hideAlert();
+
+    PERF_FRAME();
 }
\ No newline at end of file
@@ -82,12 +82,22 @@ int ui_getButtonCount(void);
 
 /**
  * @brief Register a value for display and updates
+ *
+ * The value is formatted with @p format and centered in the bounding box.
+ * Re-registering an ID already on screen rebinds it in place.
  * @param id Label ID
- * @param x X coordinate
- * @param y Y coordinate
- * @param initialValue Initial display value
+ * @param x Bounding box X
+ * @param y Bounding box Y
+ * @param w Bounding box width
+ * @param h Bounding box height
+ * @param format printf format for the value (e.g. "%d%%")
+ * @param font Font used to render the value
+ * @param fgColor Text color
+ * @param bgColor Background color of the bounding box
  */
-void ui_registerValue(LabelID id, int16_t x, int16_t y, int16_t initialValue);
+void ui_registerValue(LabelID id, int16_t x, int16_t y, int16_t w, int16_t h,
+                      const char *format, const GFXfont *font,
+                      uint16_t fgColor, uint16_t bgColor);
 
 /**
  * @brief Update a registered value
@@ -96,8 +106,19 @@ void ui_registerValue(LabelID id, int16_t x, int16_t y, int16_t initialValue);
  */
 void ui_updateValue(LabelID id, int16_t newValue);
 
+/**
+ * @brief Get the latest value reported for a label
+ *
+ * Values are remembered even when not registered on the current screen.
+ * @param id Label ID
+ * @return Last value passed to ui_updateValue (0 if never set)
+ */
+int16_t ui_getValue(LabelID id);
+
 /**
  * @brief Redraw values that have changed
+ *
+ * Only glyph cells whose character or position changed are repainted.
  */
 void ui_redrawValues(void);
 
@@ -112,19 +133,27 @@ void ui_clearValues(void);
 
 /**
  * @brief Show an alert message
+ *
+ * The banner is an overlay: the page pixels under it are read back from
+ * display RAM first and restored when it goes. A higher-priority type
+ * (error > warn > info) takes the banner at once, anything else waits in
+ * a queue of ALERT_QUEUE_SIZE.
  * @param msg Alert message text
  * @param type Alert type (info/warn/error)
  */
 void ui_showAlert(const char *msg, AlertType type);
 
 /**
- * @brief Hide the current alert (called automatically after timeout)
+ * @brief Retire the current alert after ALERT_TIMEOUT_MS (called from ui_update)
+ *
+ * Shows the next queued alert, or restores the saved pixels. If they did
+ * not fit in ALERT_SAVE_RUNS the page is redrawn instead.
  */
 void ui_hideAlert(void);
 
 /**
- * @brief Draw an alert banner
- * @param text Alert text
+ * @brief Draw an alert banner with its text
+ * @param text Alert text, clipped to the banner width
  * @param type Alert type
  */
 void ui_drawAlert(const char *text, AlertType type);
@@ -133,6 +162,37 @@ void ui_drawAlert(const char *text, AlertType type);
 // Screen Management
 // ===================================
 
+/**
+ * @brief Register the lifecycle hooks for a screen
+ * @param screen Screen ID
+ * @param page Hooks (must stay valid, usually a const in the page module)
+ */
+void ui_registerPage(ScreenID screen, const UIPage *page);
+
+/**
+ * @brief Allocate zeroed memory from the page arena
+ *
+ * The arena is reset on every page switch, so everything allocated here
+ * belongs to the visible page and hidden pages hold no RAM.
+ * @param size Bytes needed (rounded up to 4)
+ * @return Pointer or NULL if PAGE_ARENA_SIZE would be exceeded. onEnter
+ *         then returns early; ui_setScreen() goes back to the previous page.
+ */
+void *ui_pageAlloc(size_t size);
+
+/**
+ * @brief Bytes still free in the page arena
+ * @return Free bytes
+ */
+size_t ui_pageAvailable(void);
+
+/**
+ * @brief Highest arena use seen for a screen
+ * @param screen Screen ID
+ * @return Peak bytes
+ */
+uint16_t ui_getArenaPeak(ScreenID screen);
+
 /**
  * @brief Switch to a different screen
  * @param screen Screen ID to switch to
@@ -163,6 +223,9 @@ void ui_requestRedraw(void);
 
 /**
  * @brief Draw the current screen (if needed)
+ *
+ * Rendering is time-sliced: slices are drawn until RENDER_BUDGET_US is
+ * spent or touch input is pending, and the rest resumes on the next call.
  */
 void ui_drawScreen(void);
 
@@ -210,32 +273,37 @@ void ui_setGPS(bool locked);
 
 /**
  * @brief Update GPS coordinates display
- * @param lat Latitude
- * @param lon Longitude
+ * @param latE7 Latitude, degrees x 1e7
+ * @param lonE7 Longitude, degrees x 1e7
  * @param valid GPS data valid
  */
-void ui_setGPSCoordinates(float lat, float lon, bool valid);
+void ui_setGPSCoordinates(int32_t latE7, int32_t lonE7, bool valid);
+
+/**
+ * @brief Show boot progress in the middle of the header
+ * @param text Short status, or NULL to clear it once boot is done
+ */
+void ui_setBootStatus(const char *text);
 
 // ===================================
 // Touch Handling
 // ===================================
 
 /**
- * @brief Handle a touch event at the given coordinates
- * @param x X coordinate
- * @param y Y coordinate
+ * @brief Route a recognized gesture to the header, navbar or current screen
+ * @param ev Gesture event from the input pipeline
  */
-void ui_handleTouch(int16_t x, int16_t y);
+void ui_handleEvent(const UIEvent *ev);
 
 /**
- * @brief Handle navbar touch
+ * @brief Handle navbar tap
  * @param x X coordinate
  * @param y Y coordinate
  */
 void ui_handleNavbar(int16_t x, int16_t y);
 
 /**
- * @brief Handle header touch (for GPS debug)
+ * @brief Handle header tap (for GPS debug)
  * @param x X coordinate
  * @param y Y coordinate
  */
@@ -247,7 +315,16 @@ void ui_handleHeader(int16_t x, int16_t y);
 
 /**
  * @brief Main UI update function - call this in loop()
+ *
+ * After DISPLAY_IDLE_MS without input the panel is put in idle mode; the
+ * touch that wakes it is not delivered to the page.
  */
 void ui_update(void);
 
+/**
+ * @brief Check whether the panel is in idle mode
+ * @return true while idle
+ */
+bool ui_isDisplayIdle(void);
+
 #endif // UI_ENGINE_H
\ No newline at end of file
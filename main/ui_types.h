@@ -8,6 +8,7 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "fonts_pro.h"
 
 // ===================================
 // Screen IDs Enumeration
@@ -70,10 +71,18 @@ typedef struct
 typedef struct
 {
     LabelID id;
-    int16_t x;
+    int16_t x; // Bounding box the value is centered in
     int16_t y;
+    int16_t w;
+    int16_t h;
+    const char *format;   // printf format for the value, e.g. "%d%%"
+    const GFXfont *font;  // Font used for the glyph cells
+    uint16_t fgColor;
+    uint16_t bgColor;
     int16_t value;
     int16_t lastValue;
+    char text[MAX_VALUE_TEXT_LEN]; // Glyphs currently on screen
+    int16_t textX;                 // X of the first on-screen glyph cell
     bool needsRedraw;
 } UIValue;
 
@@ -87,6 +96,88 @@ typedef struct
     bool pressed;
 } TouchPoint;
 
+// ===================================
+// Touch Input Events
+// ===================================
+
+// Raw contact transitions produced by the touch sampler
+typedef enum
+{
+    TOUCH_DOWN = 0,
+    TOUCH_MOVE,
+    TOUCH_UP
+} TouchPhase;
+
+typedef struct
+{
+    TouchPhase phase;
+    int16_t x;
+    int16_t y;
+    uint32_t timeUs; // micros() when the sample was taken
+} TouchSample;
+
+// Gestures produced by the recognizer and routed to screens
+typedef enum
+{
+    UI_EVENT_NONE = 0,
+    UI_EVENT_TAP,
+    UI_EVENT_LONG_PRESS,
+    UI_EVENT_DRAG_START,
+    UI_EVENT_DRAG,
+    UI_EVENT_DRAG_END,
+    UI_EVENT_FLING
+} UIEventType;
+
+typedef struct
+{
+    UIEventType type;
+    int16_t x;       // Current contact position
+    int16_t y;
+    int16_t startX;  // Where the contact went down
+    int16_t startY;
+    int16_t dx;      // Movement since the previous drag event
+    int16_t dy;
+    int16_t vx;      // Velocity in px/s (drag end and fling)
+    int16_t vy;
+    uint32_t timeUs; // Timestamp of the sample that produced the event
+} UIEvent;
+
+// ===================================
+// Save-Under Buffer
+// ===================================
+// Display RAM under an overlay, run-length encoded in raster order
+typedef struct
+{
+    uint16_t count;
+    uint16_t color;
+} PixelRun;
+
+typedef struct
+{
+    int16_t x; // Saved rectangle
+    int16_t y;
+    int16_t w;
+    int16_t h;
+    PixelRun *runs;    // Caller-owned run storage
+    uint16_t capacity; // Number of runs in storage
+    uint16_t used;
+    bool valid;        // Saved and not overflowed
+} SaveUnder;
+
+// ===================================
+// Page Lifecycle Hooks
+// ===================================
+// Any hook may be NULL. State a page needs only while visible is taken
+// from ui_pageAlloc() in onEnter and is gone after onExit.
+typedef struct
+{
+    void (*onEnter)(void);              // Page became current
+    void (*onExit)(void);               // Page is being left
+    void (*onUpdate)(void);             // Every frame once fully drawn
+    bool (*onDraw)(uint8_t slice);      // Draw one slice, true while more remain
+    void (*onEvent)(const UIEvent *ev); // Content-area gestures (NULL = buttons)
+} UIPage;
+
 // ===================================
 // UI State Structure
 // ===================================
@@ -97,7 +188,8 @@ typedef struct
     AlertType alertType;
     char alertMsg[MAX_ALERT_LEN];
     uint32_t alertTime;
-    bool needsFullRedraw;
+    bool needsFullRedraw;   // Set until every slice of the page is drawn
+    uint8_t renderSlice;    // Next slice of an in-progress page render
     bool needsNavbarRedraw; // Separate flag for navbar
     int16_t lastTouchX;
     int16_t lastTouchY;
@@ -105,8 +197,8 @@ typedef struct
     uint8_t gsmSignal;
     uint8_t batteryLevel;
     bool gpsLock;
-    float gpsLatitude;
-    float gpsLongitude;
+    int32_t gpsLatE7;           // Degrees x 1e7 (geo.h)
+    int32_t gpsLonE7;
     bool gpsValid;
 } UIState;
 
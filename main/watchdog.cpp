@@ -0,0 +1,146 @@
+/**
+ * @file watchdog.cpp
+ * @brief Hardware Watchdog Implementation
+ */
+
+#include "watchdog.h"
+#include "scheduler.h"
+
+#define WDT_CRUMB_MAGIC 0x57445443UL // "WDTC"
+
+static WdtCrumb lastCrumb;
+static bool lastCrumbValid = false;
+
+#if WATCHDOG_ENABLED && defined(ARDUINO_ARCH_SAMD)
+
+#include <SD.h>
+
+// Not cleared by the C runtime, so it is still there after the reset
+static WdtCrumb crumb __attribute__((section(".noinit")));
+
+static uint32_t wdt_checksum(const WdtCrumb *c)
+{
+    return c->magic ^ c->pc ^ c->lr;
+}
+
+// Called from the naked handler with the exception frame on the stack:
+// r0 r1 r2 r3 r12 lr pc xpsr
+extern "C" void wdt_earlyWarning(uint32_t *frame)
+{
+    crumb.magic = WDT_CRUMB_MAGIC;
+    crumb.pc = frame[6];
+    crumb.lr = frame[5];
+    crumb.uptimeMs = millis();
+
+    const char *name = sched_currentTask();
+    strncpy(crumb.task, name ? name : "loop", sizeof(crumb.task) - 1);
+    crumb.task[sizeof(crumb.task) - 1] = '\0';
+    crumb.check = wdt_checksum(&crumb);
+
+    WDT->INTFLAG.reg = WDT_INTFLAG_EW;
+}
+
+extern "C" __attribute__((naked)) void WDT_Handler(void)
+{
+    __asm volatile(
+        "mrs r0, msp\n"
+        "b wdt_earlyWarning\n");
+}
+
+static void wdt_formatCrumb(char *line, size_t len)
+{
+    snprintf(line, len, "WDT reset: task=%s pc=0x%08lx lr=0x%08lx uptime=%lums",
+             lastCrumb.task, (unsigned long)lastCrumb.pc, (unsigned long)lastCrumb.lr,
+             (unsigned long)lastCrumb.uptimeMs);
+}
+
+void wdt_begin(void)
+{
+    // Was the last reset ours, and did the early warning get to run?
+    if (PM->RCAUSE.bit.WDT && crumb.magic == WDT_CRUMB_MAGIC &&
+        crumb.check == wdt_checksum(&crumb))
+    {
+        lastCrumb = crumb;
+        lastCrumbValid = true;
+
+        char line[96];
+        wdt_formatCrumb(line, sizeof(line));
+        SerialUSB.println(line);
+    }
+    memset(&crumb, 0, sizeof(crumb));
+
+    // GCLK2 = OSCULP32K / 32 = 1.024 kHz for the WDT
+    GCLK->GENDIV.reg = GCLK_GENDIV_ID(2) | GCLK_GENDIV_DIV(4);
+    GCLK->GENCTRL.reg = GCLK_GENCTRL_ID(2) | GCLK_GENCTRL_GENEN |
+                        GCLK_GENCTRL_SRC_OSCULP32K | GCLK_GENCTRL_DIVSEL;
+    while (GCLK->STATUS.bit.SYNCBUSY)
+        ;
+    GCLK->CLKCTRL.reg = GCLK_CLKCTRL_ID_WDT | GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK2;
+
+    WDT->CTRL.reg = 0;
+    while (WDT->STATUS.bit.SYNCBUSY)
+        ;
+    WDT->CONFIG.reg = WDT_CONFIG_PER_4K;      // Reset after 4096 cycles (~4 s)
+    WDT->EWCTRL.reg = WDT_EWCTRL_EWOFFSET_2K; // Early warning after ~2 s
+    WDT->INTENSET.reg = WDT_INTENSET_EW;
+    NVIC_SetPriority(WDT_IRQn, 0);
+    NVIC_EnableIRQ(WDT_IRQn);
+    WDT->CTRL.reg = WDT_CTRL_ENABLE;
+    while (WDT->STATUS.bit.SYNCBUSY)
+        ;
+
+    SerialUSB.println(F("Watchdog armed (~4 s)"));
+}
+
+void wdt_feed(void)
+{
+    // A clear while the previous one is still syncing would stall the bus
+    if (!WDT->STATUS.bit.SYNCBUSY)
+    {
+        WDT->CLEAR.reg = WDT_CLEAR_CLEAR_KEY;
+    }
+    // Early warning fired but we recovered: not the crumb of a reset
+    crumb.magic = 0;
+}
+
+void wdt_logLastReset(void)
+{
+    if (!lastCrumbValid)
+    {
+        return;
+    }
+
+    char line[96];
+    wdt_formatCrumb(line, sizeof(line));
+    File log = SD.open("stall_log.txt", FILE_WRITE);
+    if (log)
+    {
+        log.println(line);
+        log.close();
+    }
+}
+
+#else
+
+void wdt_begin(void)
+{
+}
+
+void wdt_logLastReset(void)
+{
+}
+
+void wdt_feed(void)
+{
+}
+
+#endif
+
+bool wdt_getLastCrumb(WdtCrumb *out)
+{
+    if (lastCrumbValid)
+    {
+        *out = lastCrumb;
+    }
+    return lastCrumbValid;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file watchdog.h
+ * @brief Hardware Watchdog with Stall Breadcrumb
+ *
+ * Enabled with WATCHDOG_ENABLED in config.h. The SAMD21 WDT resets the
+ * board if loop() does not come round for ~4 s. Its early-warning
+ * interrupt fires ~2 s in and stores a breadcrumb - the running task and
+ * the interrupted PC/LR - in RAM that survives the reset. Writing to SD
+ * from that interrupt is not safe, so the next boot prints the breadcrumb
+ * to SerialUSB and, once the card is mounted, appends it to stall_log.txt.
+ *
+ * Resolve the PC with: arm-none-eabi-addr2line -e main.ino.elf <pc>
+ */
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===================================
+// Breadcrumb
+// ===================================
+typedef struct
+{
+    uint32_t magic;
+    uint32_t pc;       // Instruction the early warning interrupted
+    uint32_t lr;       // Its caller
+    uint32_t uptimeMs;
+    char task[12];     // Scheduler task running at the time
+    uint32_t check;    // magic ^ pc ^ lr, rejects stale or random RAM
+} WdtCrumb;
+
+// ===================================
+// Watchdog Functions
+// ===================================
+
+/**
+ * @brief Print a watchdog reset from the last run, then start the WDT
+ *
+ * Call at the end of setup(), so the blocking part of boot is not watched.
+ */
+void wdt_begin(void);
+
+/**
+ * @brief Append the last run's breadcrumb, if any, to stall_log.txt
+ *
+ * Call once after the SD card is mounted; wdt_begin() runs before that.
+ */
+void wdt_logLastReset(void);
+
+/**
+ * @brief Restart the watchdog period - call once per loop()
+ */
+void wdt_feed(void);
+
+/**
+ * @brief Get the breadcrumb that caused the last reset
+ * @param out Structure to fill
+ * @return true if the last reset was a watchdog reset with a valid crumb
+ */
+bool wdt_getLastCrumb(WdtCrumb *out);
+
+#endif // WATCHDOG_H
@@ -0,0 +1,158 @@
+/**
+ * @file workqueue.cpp
+ * @brief Idle-Time Background Work Queue Implementation
+ */
+
+#include "workqueue.h"
+
+// ===================================
+// Queue
+// ===================================
+
+typedef struct
+{
+    const char *name;
+    WorkFn fn;
+    void *ctx;
+    uint32_t submitUs;
+    bool started;
+    bool starved;   // Counted in stats.starved
+} WorkItem;
+
+static WorkItem queue[WORK_QUEUE_SIZE];
+static uint8_t head = 0;
+static uint8_t count = 0;
+
+static WorkStats stats;
+static uint32_t startedCount = 0;
+
+static void work_average(uint32_t *avg, uint32_t *max, uint32_t sample, uint32_t n)
+{
+    if (sample > *max)
+    {
+        *max = sample;
+    }
+    *avg = (n == 1) ? sample : *avg - (*avg >> 3) + (sample >> 3);
+}
+
+// ===================================
+// Public API
+// ===================================
+
+bool work_submit(const char *name, WorkFn fn, void *ctx)
+{
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const WorkItem *item = &queue[(head + i) % WORK_QUEUE_SIZE];
+        if (item->fn == fn && item->ctx == ctx)
+        {
+            return true;
+        }
+    }
+
+    if (count >= WORK_QUEUE_SIZE || fn == NULL)
+    {
+        stats.rejected++;
+        return false;
+    }
+
+    WorkItem *item = &queue[(head + count) % WORK_QUEUE_SIZE];
+    item->name = name;
+    item->fn = fn;
+    item->ctx = ctx;
+    item->submitUs = micros();
+    item->started = false;
+    item->starved = false;
+    count++;
+
+    stats.submitted++;
+    stats.depth = count;
+    if (count > stats.peakDepth)
+    {
+        stats.peakDepth = count;
+    }
+    return true;
+}
+
+void work_idle(uint32_t slackUs)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    if (slackUs < WORK_MIN_SLACK_US)
+    {
+        // Short gaps are normal; count an item only once it has waited
+        // too long for a usable one
+        WorkItem *next = &queue[head];
+        if (!next->starved && micros() - next->submitUs > WORK_STARVE_US)
+        {
+            next->starved = true;
+            stats.starved++;
+        }
+        return;
+    }
+
+    WorkItem item = queue[head];
+    head = (head + 1) % WORK_QUEUE_SIZE;
+    count--;
+
+    uint32_t start = micros();
+    if (!item.started)
+    {
+        item.started = true;
+        startedCount++;
+        work_average(&stats.avgWaitUs, &stats.maxWaitUs, start - item.submitUs, startedCount);
+    }
+
+    uint32_t slice = (slackUs < WORK_SLICE_US) ? slackUs : WORK_SLICE_US;
+    WorkStatus status = item.fn(item.ctx, start + slice);
+    uint32_t end = micros();
+
+    stats.slices++;
+    if (end - start > WORK_SLICE_US)
+    {
+        stats.overruns++;
+    }
+
+    if (status == WORK_MORE)
+    {
+        // Back of the line: every queued item gets a slice before this one again
+        queue[(head + count) % WORK_QUEUE_SIZE] = item;
+        count++;
+    }
+    else
+    {
+        stats.completed++;
+        work_average(&stats.avgLatencyUs, &stats.maxLatencyUs, end - item.submitUs,
+                     stats.completed);
+    }
+    stats.depth = count;
+}
+
+bool work_pending(void)
+{
+    return count > 0;
+}
+
+const WorkStats *work_getStats(void)
+{
+    return &stats;
+}
+
+void work_printStats(void)
+{
+    char line[112];
+    snprintf(line, sizeof(line), "work depth=%u/%u done=%lu/%lu rej=%lu",
+             stats.depth, stats.peakDepth, (unsigned long)stats.completed,
+             (unsigned long)stats.submitted, (unsigned long)stats.rejected);
+    SerialUSB.println(line);
+    snprintf(line, sizeof(line), "     slices=%lu over=%lu starved=%lu",
+             (unsigned long)stats.slices, (unsigned long)stats.overruns,
+             (unsigned long)stats.starved);
+    SerialUSB.println(line);
+    snprintf(line, sizeof(line), "     wait avg/max=%lu/%lu us  latency avg/max=%lu/%lu us",
+             (unsigned long)stats.avgWaitUs, (unsigned long)stats.maxWaitUs,
+             (unsigned long)stats.avgLatencyUs, (unsigned long)stats.maxLatencyUs);
+    SerialUSB.println(line);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file workqueue.h
+ * @brief Idle-Time Background Work Queue
+ *
+ * Work items are resumable functions that do a little at a time. They
+ * only run from loop() when the scheduler has nothing due, one slice of
+ * at most WORK_SLICE_US per idle pass, and the item just run goes to the
+ * back of the queue so a long job cannot starve the others.
+ */
+
+#ifndef WORKQUEUE_H
+#define WORKQUEUE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ===================================
+// Work Item Types
+// ===================================
+typedef enum
+{
+    WORK_DONE = 0, // Item finished, remove it
+    WORK_MORE      // Item has more to do, run it again later
+} WorkStatus;
+
+// Do work until micros() reaches deadlineUs (checked between small steps)
+typedef WorkStatus (*WorkFn)(void *ctx, uint32_t deadlineUs);
+
+// ===================================
+// Queue Statistics
+// ===================================
+typedef struct
+{
+    uint8_t depth;         // Items queued now
+    uint8_t peakDepth;
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t rejected;     // Submits refused by a full queue
+    uint32_t slices;       // Item runs
+    uint32_t overruns;     // Slices longer than WORK_SLICE_US
+    uint32_t starved;      // Items kept waiting WORK_STARVE_US by too little slack
+    uint32_t maxWaitUs;    // Submit to first slice
+    uint32_t avgWaitUs;    // Running average (1/8 weight)
+    uint32_t maxLatencyUs; // Submit to done
+    uint32_t avgLatencyUs; // Running average (1/8 weight)
+} WorkStats;
+
+// ===================================
+// Work Queue Functions
+// ===================================
+
+/**
+ * @brief Queue a work item
+ *
+ * Submitting an item that is already queued (same fn and ctx) is a no-op,
+ * so "flush when idle" requests coalesce.
+ * @param name Short name for debugging
+ * @param fn Work function
+ * @param ctx Passed to fn, must stay valid until the item is done
+ * @return false if the queue is full
+ */
+bool work_submit(const char *name, WorkFn fn, void *ctx);
+
+/**
+ * @brief Run one slice of the next item - call when the scheduler is idle
+ * @param slackUs Time until the next task is due (sched_slackUs())
+ */
+void work_idle(uint32_t slackUs);
+
+/**
+ * @brief Check for queued work
+ * @return true if any item is waiting
+ */
+bool work_pending(void);
+
+/**
+ * @brief Get queue statistics
+ * @return Pointer to statistics
+ */
+const WorkStats *work_getStats(void);
+
+/**
+ * @brief Print queue depth, throughput and latency over SerialUSB
+ */
+void work_printStats(void);
+
+#endif // WORKQUEUE_H
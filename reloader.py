@@ -7,12 +7,21 @@ from pynput import keyboard
 # --- CONFIGURATION ---
 # Simple, fast compile command
 COMPILE_CMD = (
-    "g++ -std=c++11 "
+    "g++ -std=c++11 -DPERF_ENABLED=1 "
     "desktop/main.cpp "
     "desktop/sdl_renderer.cpp "
     "desktop/desktop_stubs.cpp "
     "main/pages/home/home_page.cpp "
     "main/pages/files/files_page.cpp " 
+    "main/a9g_gps.cpp "
+    "main/at_engine.cpp "
+    "main/uart_rx.cpp "
+    "main/nmea.cpp "
+    "main/geo.cpp "
+    "main/track_log.cpp "
+    "main/track_simplify.cpp "
+    "main/workqueue.cpp "
+    "desktop/a9g_emulator.cpp "
     "-I./desktop -I./main "
     "-lSDL2 -o soil_sim"
 )
@@ -0,0 +1,146 @@
+/**
+ * @file nmea_bench.cpp
+ * @brief Host Benchmark for the Streaming NMEA Parser
+ *
+ * Feeds a recorded NMEA log through nmea_feed() byte by byte and reports
+ * sentences per second plus the parser's error counters. Lines may carry
+ * the A9G "+GPSRD:" prefix. Without a log, one hour of 1 Hz output
+ * (GGA, RMC, GSA, 3x GSV, VTG) is synthesized, with every 1000th
+ * sentence given a bad checksum.
+ *
+ *     g++ -O2 -std=c++11 -Idesktop -Imain tools/nmea_bench.cpp main/nmea.cpp main/geo.cpp -o nmea_bench
+ *     ./nmea_bench [capture.nmea] [passes]
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include "nmea.h"
+
+// ===================================
+// Synthetic Log
+// ===================================
+
+static void bench_sentence(std::string &out, const char *body, bool corrupt)
+{
+    uint8_t sum = 0;
+    for (const char *p = body; *p; p++)
+    {
+        sum ^= (uint8_t)*p;
+    }
+    char tail[8];
+    snprintf(tail, sizeof(tail), "*%02X\r\n", corrupt ? sum ^ 0x55 : sum);
+    out += "$";
+    out += body;
+    out += tail;
+}
+
+static std::string bench_synthesize(uint32_t seconds)
+{
+    std::string log;
+    char body[96];
+    uint32_t n = 0;
+    for (uint32_t t = 0; t < seconds; t++)
+    {
+        unsigned hh = t / 3600 % 24, mm = t / 60 % 60, ss = t % 60;
+        // Slow drift north-east from New Delhi
+        double latMin = 36.834 + t * 0.00021;
+        double lonMin = 12.540 + t * 0.00017;
+        const char *bodies[7];
+        char gga[96], rmc[96];
+        snprintf(gga, sizeof(gga), "GPGGA,%02u%02u%02u.00,28%08.5f,N,077%08.5f,E,1,08,0.9,%.1f,M,-52.0,M,,",
+                 hh, mm, ss, latMin, lonMin, 210.0 + (t % 50) * 0.1);
+        snprintf(rmc, sizeof(rmc), "GPRMC,%02u%02u%02u.00,A,28%08.5f,N,077%08.5f,E,1.20,45.00,181026,,,A",
+                 hh, mm, ss, latMin, lonMin);
+        bodies[0] = gga;
+        bodies[1] = rmc;
+        bodies[2] = "GPGSA,A,3,02,05,07,09,13,16,20,30,,,,,1.6,0.9,1.3";
+        bodies[3] = "GPGSV,3,1,11,02,41,312,38,05,22,047,31,07,63,151,44,09,18,276,29";
+        bodies[4] = "GPGSV,3,2,11,13,55,082,42,16,12,201,26,20,34,118,35,30,71,004,45";
+        bodies[5] = "GPGSV,3,3,11,11,05,330,,18,03,160,,25,08,240,";
+        bodies[6] = "GPVTG,45.00,T,,M,1.20,N,2.22,K,A";
+        for (int i = 0; i < 7; i++)
+        {
+            strcpy(body, bodies[i]);
+            bench_sentence(log, body, ++n % 1000 == 0);
+        }
+    }
+    return log;
+}
+
+static bool bench_load(const char *path, std::string &log)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        return false;
+    }
+    char buf[4096];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), f)) > 0)
+    {
+        log.append(buf, len);
+    }
+    fclose(f);
+    return true;
+}
+
+// ===================================
+// Benchmark
+// ===================================
+
+int main(int argc, char **argv)
+{
+    std::string log;
+    if (argc > 1)
+    {
+        if (!bench_load(argv[1], log))
+        {
+            fprintf(stderr, "cannot read %s\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        log = bench_synthesize(3600);
+    }
+    int passes = (argc > 2) ? atoi(argv[2]) : 20;
+
+    NmeaParser parser;
+    GPSData fix;
+    uint32_t byType[NMEA_VTG + 1] = {0};
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        nmea_init(&parser);
+        memset(&fix, 0, sizeof(fix));
+        memset(byType, 0, sizeof(byType));
+        const char *p = log.data();
+        const char *end = p + log.size();
+        for (; p < end; p++)
+        {
+            byType[nmea_feed(&parser, *p, &fix)]++;
+        }
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint32_t total = parser.sentences + parser.checksumErrors + parser.malformed + parser.ignored;
+    printf("log: %zu bytes, %lu sentences, %d passes in %.3f s\n", log.size(),
+           (unsigned long)total, passes, secs);
+    printf("rate: %.0f sentences/s, %.1f MB/s\n", total * passes / secs,
+           log.size() * passes / secs / 1e6);
+    printf("applied=%lu checksum=%lu malformed=%lu ignored=%lu\n",
+           (unsigned long)parser.sentences, (unsigned long)parser.checksumErrors,
+           (unsigned long)parser.malformed, (unsigned long)parser.ignored);
+    printf("GGA=%lu RMC=%lu GSA=%lu GSV=%lu VTG=%lu\n", (unsigned long)byType[NMEA_GGA],
+           (unsigned long)byType[NMEA_RMC], (unsigned long)byType[NMEA_GSA],
+           (unsigned long)byType[NMEA_GSV], (unsigned long)byType[NMEA_VTG]);
+    char lat[16], lon[16];
+    geo_formatE7(lat, sizeof(lat), fix.latE7, 7);
+    geo_formatE7(lon, sizeof(lon), fix.lonE7, 7);
+    printf("last fix: valid=%d %s,%s alt=%.1f sats=%u/%u hdop=%.1f %.2fkm/h %.1fdeg %s %06lu\n",
+           fix.valid, lat, lon, fix.altitude, fix.satellites, fix.satsInView,
+           fix.hdop, fix.speedKmh, fix.course, fix.lastUpdate, (unsigned long)fix.utcDate);
+    return 0;
+}
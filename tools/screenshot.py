@@ -0,0 +1,178 @@
+"""
+Grab a screenshot from the device over SerialUSB.
+
+Sends the console "shot" command, collects the RLE band frames described
+in main/screenshot.h and writes a PNG. Text the firmware prints between
+frames is skipped.
+
+    python tools/screenshot.py --port /dev/ttyACM0 --out screen.png
+    python tools/screenshot.py --input capture.bin --out screen.png
+"""
+import argparse
+import struct
+import sys
+import time
+
+from PIL import Image
+
+SYNC = b"SH"
+HEADER_FIELDS = 6  # width, height, bandLines, scrollTop, scrollHeight, scrollLine
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def decode_rle(data, pos, count):
+    """Decode `count` RGB565 pixels starting at data[pos]; returns (pixels, end)."""
+    pixels = []
+    while len(pixels) < count:
+        ctrl = data[pos]
+        pos += 1
+        if ctrl & 0x80:
+            (color,) = struct.unpack_from("<H", data, pos)
+            pos += 2
+            pixels.extend([color] * ((ctrl & 0x7F) + 2))
+        else:
+            n = ctrl + 1
+            pixels.extend(struct.unpack_from("<%dH" % n, data, pos))
+            pos += 2 * n
+    if len(pixels) != count:
+        raise ValueError("band overruns its pixel count")
+    return pixels, pos
+
+
+class Capture:
+    def __init__(self):
+        self.header = None
+        self.ram = None
+        self.done = False
+        self.skipped = 0
+
+    def parse(self, data):
+        """Consume complete frames from `data`, return the unconsumed tail."""
+        pos = 0
+        while not self.done:
+            start = data.find(SYNC, pos)
+            if start < 0:
+                return data[-1:] if data.endswith(b"S") else b""
+            end = self._frame(data, start + 2)
+            if end is None:
+                return data[start:]  # Incomplete, wait for more bytes
+            if end < 0:
+                pos = start + 1      # Bad CRC or junk that looked like sync
+                self.skipped += 1
+                continue
+            pos = end
+        return b""
+
+    def _frame(self, data, pos):
+        if pos >= len(data):
+            return None
+        body_start = pos
+        kind = chr(data[pos])
+        pos += 1
+        try:
+            if kind == "H":
+                fields = struct.unpack_from("<%dH" % HEADER_FIELDS, data, pos)
+                pos += 2 * HEADER_FIELDS
+            elif kind == "B":
+                if self.header is None:
+                    return -1
+                y, lines = struct.unpack_from("<HH", data, pos)
+                pos += 4
+                if lines == 0 or lines > self.header[2] or y + lines > self.header[1]:
+                    return -1
+                pixels, pos = decode_rle(data, pos, self.header[0] * lines)
+            elif kind == "E":
+                bands, lo, hi = struct.unpack_from("<HHH", data, pos)
+                pos += 6
+            else:
+                return -1
+            (crc,) = struct.unpack_from("<H", data, pos)
+        except (struct.error, IndexError):
+            return None
+        if crc16(data[body_start:pos]) != crc:
+            return -1
+        pos += 2
+
+        if kind == "H":
+            self.header = fields
+            self.ram = [0] * (fields[0] * fields[1])
+        elif kind == "B":
+            w = self.header[0]
+            self.ram[y * w:(y + lines) * w] = pixels
+        else:
+            self.done = True
+        return pos
+
+    def image(self):
+        w, h, _, top, height, line = self.header
+        img = Image.new("RGB", (w, h))
+        out = img.load()
+        for y in range(h):
+            # Undo the hardware scroll the same way the panel scans out RAM
+            src = y
+            if top <= y < top + height and height > 0:
+                src = top + (y - top + line - top) % height
+            row = self.ram[src * w:(src + 1) * w]
+            for x, c in enumerate(row):
+                out[x, y] = (((c >> 11) & 0x1F) << 3, ((c >> 5) & 0x3F) << 2, (c & 0x1F) << 3)
+        return img
+
+
+def read_serial(port, baud, timeout, raw_out):
+    import serial  # pyserial, only needed for live captures
+
+    cap = Capture()
+    pending = b""
+    raw = bytearray()
+    with serial.Serial(port, baud, timeout=0.2) as ser:
+        ser.reset_input_buffer()
+        ser.write(b"shot\n")
+        deadline = time.time() + timeout
+        while not cap.done:
+            if time.time() > deadline:
+                sys.exit("Timed out waiting for the capture to finish")
+            chunk = ser.read(4096)
+            raw += chunk
+            pending = cap.parse(pending + chunk)
+    if raw_out:
+        with open(raw_out, "wb") as f:
+            f.write(raw)
+    return cap
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--port", help="Serial port of the device")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--timeout", type=float, default=30.0)
+    ap.add_argument("--input", help="Decode a saved capture instead of a live port")
+    ap.add_argument("--save-raw", help="Also save the raw serial stream")
+    ap.add_argument("--out", default="screenshot.png")
+    args = ap.parse_args()
+
+    if args.input:
+        cap = Capture()
+        with open(args.input, "rb") as f:
+            cap.parse(f.read())
+        if not cap.done:
+            sys.exit("Capture is incomplete")
+    elif args.port:
+        cap = read_serial(args.port, args.baud, args.timeout, args.save_raw)
+    else:
+        sys.exit("Need --port or --input")
+
+    cap.image().save(args.out)
+    print(f"Saved {args.out} ({cap.header[0]}x{cap.header[1]}, {cap.skipped} false syncs skipped)")
+
+
+if __name__ == "__main__":
+    main()
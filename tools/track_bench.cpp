@@ -0,0 +1,379 @@
+/**
+ * @file track_bench.cpp
+ * @brief Host Test for Track Simplification and Varint Encoding
+ *
+ * Runs every fix of a track through track_simplifyPush() at several
+ * tolerances, packs the kept points into track log blocks with
+ * track_encodeRecord(), decodes them again and reports the file size
+ * against the older formats and the largest distance of any original fix
+ * from the stored track. Fixes come from a recorded NMEA log (GGA/RMC,
+ * "+GPSRD:" prefixes allowed) or, without one, from a synthesized day of
+ * 1 Hz fixes: walking field rows with stops for soil readings, with
+ * drifting GPS noise.
+ *
+ * First it checks the writer's recovery: a log closed part way through a
+ * block and continued must still find every point by time. That runs on
+ * a real TRACK_FILE in a temporary directory.
+ *
+ *     g++ -O2 -std=c++11 -DSD_HOST_FILES -Idesktop -Imain tools/track_bench.cpp \
+ *         main/track_simplify.cpp main/track_log.cpp main/geo.cpp main/nmea.cpp -o track_bench
+ *     ./track_bench [capture.nmea]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <unistd.h>
+#include <Arduino.h>
+#include "nmea.h"
+#include "track_log.h"
+#include "track_simplify.h"
+
+// ===================================
+// Track Sources
+// ===================================
+
+static uint32_t benchRandState = 2463534242u;
+
+static double bench_uniform(void)
+{
+    benchRandState ^= benchRandState << 13;
+    benchRandState ^= benchRandState >> 17;
+    benchRandState ^= benchRandState << 5;
+    return (benchRandState + 0.5) / 4294967296.0;
+}
+
+static double bench_gauss(void)
+{
+    return sqrt(-2.0 * log(bench_uniform())) * cos(6.283185307 * bench_uniform());
+}
+
+static const double BENCH_M_PER_DEG = 111195.0;
+
+// Rows 120 m long, 3 m apart, walked at 1.1 m/s; a 3-minute stop for a
+// reading every 40 m; fix noise is a slow random drift plus jitter
+static void bench_synthesize(std::vector<TrackPoint> &fixes, uint32_t seconds)
+{
+    const double lat0 = 28.6139, lon0 = 77.2090;
+    const double cosLat = cos(lat0 * M_PI / 180.0);
+    double x = 0, y = 0, heading = 1;
+    double driftX = 0, driftY = 0;
+    uint32_t stopLeft = 0;
+    double sinceStop = 0, rowLeft = 120;
+    uint32_t t0 = 845000000u; // 2026-10-11
+
+    for (uint32_t t = 0; t < seconds; t++)
+    {
+        if (stopLeft > 0)
+        {
+            stopLeft--;
+        }
+        else if (rowLeft > 0)
+        {
+            double step = 1.1 + 0.15 * bench_gauss();
+            x += heading * step;
+            rowLeft -= step;
+            sinceStop += step;
+            if (sinceStop >= 40)
+            {
+                sinceStop = 0;
+                stopLeft = 180;
+            }
+        }
+        else
+        {
+            // Turn into the next row
+            y += 3;
+            heading = -heading;
+            rowLeft = 120;
+        }
+
+        driftX = driftX * 0.97 + 0.35 * bench_gauss();
+        driftY = driftY * 0.97 + 0.35 * bench_gauss();
+        double nx = x + driftX + 0.4 * bench_gauss();
+        double ny = y + driftY + 0.4 * bench_gauss();
+
+        TrackPoint p;
+        p.time = t0 + t;
+        p.latE7 = (int32_t)lround((lat0 + ny / BENCH_M_PER_DEG) * GEO_E7);
+        p.lonE7 = (int32_t)lround((lon0 + nx / (BENCH_M_PER_DEG * cosLat)) * GEO_E7);
+        p.altM = (int16_t)lround(215 + 2 * bench_gauss());
+        fixes.push_back(p);
+    }
+}
+
+// One point per second with a fix and a date, as the A9G driver feeds them
+static bool bench_load(const char *path, std::vector<TrackPoint> &fixes)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        return false;
+    }
+    NmeaParser parser;
+    GPSData fix;
+    nmea_init(&parser);
+    memset(&fix, 0, sizeof(fix));
+    int c;
+    while ((c = fgetc(f)) != EOF)
+    {
+        NmeaType type = nmea_feed(&parser, (char)c, &fix);
+        uint32_t time = nmea_seconds(&fix);
+        if ((type == NMEA_GGA || type == NMEA_RMC) && fix.valid && time != 0 &&
+            (fixes.empty() || time > fixes.back().time))
+        {
+            TrackPoint p;
+            p.time = time;
+            p.latE7 = fix.latE7;
+            p.lonE7 = fix.lonE7;
+            p.altM = (int16_t)lround(fix.altitude);
+            fixes.push_back(p);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+// ===================================
+// Block Packing
+// ===================================
+
+// Bytes the track log would use for these points, packed as its writer does
+static uint32_t bench_pack(const std::vector<TrackPoint> &points, std::vector<TrackPoint> &decoded)
+{
+    uint8_t block[TRACK_BLOCK_PAYLOAD];
+    uint8_t rec[TRACK_RECORD_MAX];
+    uint32_t blocks = 0;
+    size_t i = 0;
+    decoded.clear();
+    while (i < points.size())
+    {
+        // The header base is the first point on the 1e-6 grid, altitude 0
+        TrackPoint base = {points[i].time, 0, 0, 0};
+        TrackPoint origin = base;
+        track_decodeRecord(rec, track_encodeRecord(rec, &origin, &points[i]), &base);
+        base.altM = 0;
+
+        uint16_t used = 0;
+        uint8_t count = 0;
+        TrackPoint prev = base;
+        while (i < points.size() && count < 255)
+        {
+            uint8_t len = track_encodeRecord(rec, &prev, &points[i]);
+            if (used + len > TRACK_BLOCK_PAYLOAD)
+            {
+                break;
+            }
+            memcpy(block + used, rec, len);
+            used += len;
+            prev = points[i++];
+            count++;
+        }
+
+        TrackPoint p = base;
+        for (uint16_t off = 0; count-- > 0;)
+        {
+            uint16_t room = TRACK_BLOCK_PAYLOAD - off;
+            off += track_decodeRecord(block + off, (room > 255) ? 255 : room, &p);
+            decoded.push_back(p);
+        }
+        blocks++;
+    }
+    blocks += blocks / TRACK_INDEX_SPAN;
+    return blocks * TRACK_BLOCK_SIZE;
+}
+
+// ===================================
+// Error Measurement
+// ===================================
+
+// Metres from p to the segment a-b on a local flat grid
+static double bench_segmentDistance(const TrackPoint &a, const TrackPoint &b, const TrackPoint &p)
+{
+    double k = cos(a.latE7 / 1e7 * M_PI / 180.0) * BENCH_M_PER_DEG / 1e7;
+    double bx = (b.lonE7 - a.lonE7) * k, by = (b.latE7 - a.latE7) * BENCH_M_PER_DEG / 1e7;
+    double px = (p.lonE7 - a.lonE7) * k, py = (p.latE7 - a.latE7) * BENCH_M_PER_DEG / 1e7;
+    double len2 = bx * bx + by * by;
+    double t = (len2 > 0) ? (px * bx + py * by) / len2 : 0;
+    t = (t < 0) ? 0 : (t > 1) ? 1 : t;
+    return hypot(px - t * bx, py - t * by);
+}
+
+// Each fix against the stored segment spanning its time
+static void bench_error(const std::vector<TrackPoint> &fixes, const std::vector<TrackPoint> &stored,
+                        double *maxM, double *meanM)
+{
+    size_t seg = 0;
+    double sum = 0;
+    *maxM = 0;
+    for (size_t i = 0; i < fixes.size(); i++)
+    {
+        while (seg + 2 < stored.size() && stored[seg + 1].time < fixes[i].time)
+        {
+            seg++;
+        }
+        const TrackPoint &a = stored[seg];
+        const TrackPoint &b = stored[(seg + 1 < stored.size()) ? seg + 1 : seg];
+        double d = bench_segmentDistance(a, b, fixes[i]);
+        sum += d;
+        if (d > *maxM)
+        {
+            *maxM = d;
+        }
+    }
+    *meanM = fixes.empty() ? 0 : sum / fixes.size();
+}
+
+// ===================================
+// Recovery Check
+// ===================================
+
+// Writes points one second apart, closing the log a third of the way in
+// so the rest continues a partly filled block, then reads ranges back
+// from every part of the file. Returns the number of bad ranges.
+static int bench_recoverSeek(const std::vector<TrackPoint> &fixes)
+{
+    char dir[] = "/tmp/track_benchXXXXXX";
+    char cwd[256];
+    if (mkdtemp(dir) == NULL || getcwd(cwd, sizeof(cwd)) == NULL || chdir(dir) != 0)
+    {
+        fprintf(stderr, "cannot make a temporary directory\n");
+        return 1;
+    }
+
+    size_t n = (fixes.size() < 5000) ? fixes.size() : 5000;
+    size_t split = n / 3 + 7;
+    uint32_t t0 = fixes[0].time;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (i == split)
+        {
+            track_end(); // As after a reboot
+        }
+        TrackPoint p = fixes[i];
+        p.time = t0 + i;
+        track_append(&p);
+    }
+    track_sync();
+
+    int bad = 0;
+    for (size_t from = 0; from + 50 < n; from += 37)
+    {
+        TrackReader r;
+        TrackPoint p;
+        uint32_t count = 0, first = 0;
+        if (track_openRange(&r, t0 + from, t0 + from + 49))
+        {
+            while (track_next(&r, &p))
+            {
+                first = (count++ == 0) ? p.time : first;
+            }
+            track_close(&r);
+        }
+        if (count != 50 || first != t0 + from)
+        {
+            if (bad++ < 5)
+            {
+                printf("  range at +%zu: %u points from +%ld\n", from, count, (long)first - (long)t0);
+            }
+        }
+    }
+    track_end();
+    remove(TRACK_FILE);
+    if (chdir(cwd) != 0 || rmdir(dir) != 0)
+    {
+        fprintf(stderr, "cannot remove %s\n", dir);
+    }
+    printf("recover and seek, %zu points split at %zu: %s\n\n", n, split, bad ? "FAILED" : "ok");
+    return bad;
+}
+
+// ===================================
+// Benchmark
+// ===================================
+
+int main(int argc, char **argv)
+{
+    std::vector<TrackPoint> fixes;
+    if (argc > 1)
+    {
+        if (!bench_load(argv[1], fixes))
+        {
+            fprintf(stderr, "cannot read %s\n", argv[1]);
+            return 1;
+        }
+    }
+    else
+    {
+        bench_synthesize(fixes, 86400);
+    }
+    if (fixes.size() < 2)
+    {
+        fprintf(stderr, "need at least two fixes\n");
+        return 1;
+    }
+    if (bench_recoverSeek(fixes) != 0)
+    {
+        return 1;
+    }
+
+    // Earlier formats: text lines in gps_log.txt, then fixed 8-byte records
+    uint32_t textBytes = 0;
+    for (size_t i = 0; i < fixes.size(); i++)
+    {
+        char line[40];
+        int n = snprintf(line, sizeof(line), "%lu,", (unsigned long)fixes[i].time);
+        n += geo_formatE7(line + n, sizeof(line) - n, fixes[i].latE7, 6);
+        line[n++] = ',';
+        n += geo_formatE7(line + n, sizeof(line) - n, fixes[i].lonE7, 6);
+        textBytes += n + 2;
+    }
+    uint32_t fixedBlocks = (fixes.size() + 61) / 62;
+    uint32_t fixedBytes = (fixedBlocks + fixedBlocks / TRACK_INDEX_SPAN) * TRACK_BLOCK_SIZE;
+    std::vector<TrackPoint> decoded;
+    uint32_t allBytes = bench_pack(fixes, decoded);
+    double quantMax = 0, quantMean = 0;
+    bench_error(fixes, decoded, &quantMax, &quantMean);
+
+    printf("fixes: %zu over %.1f h\n", fixes.size(), (fixes.back().time - fixes[0].time) / 3600.0);
+    printf("%-26s %9s %7s\n", "format", "bytes", "B/fix");
+    printf("%-26s %9lu %7.2f\n", "text (gps_log.txt)", (unsigned long)textBytes,
+           (double)textBytes / fixes.size());
+    printf("%-26s %9lu %7.2f\n", "fixed 8-byte records", (unsigned long)fixedBytes,
+           (double)fixedBytes / fixes.size());
+    printf("%-26s %9lu %7.2f  max err %.2f m\n", "varint, every fix", (unsigned long)allBytes,
+           (double)allBytes / fixes.size(), quantMax);
+
+    printf("\nsimplified (window %d, max %d s):\n", TRACK_SIMPLIFY_WINDOW, TRACK_SIMPLIFY_MAX_S);
+    printf("%8s %8s %9s %7s %8s %9s %9s %8s\n", "tol m", "kept", "bytes", "B/pt", "vs text",
+           "max err m", "mean m", "ns/fix");
+    static const uint16_t tolerances[] = {100, 200, 300, 500, 1000};
+    for (size_t t = 0; t < sizeof(tolerances) / sizeof(tolerances[0]); t++)
+    {
+        TrackSimplifier s;
+        std::vector<TrackPoint> kept;
+        TrackPoint out;
+        track_simplifyInit(&s, tolerances[t]);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < fixes.size(); i++)
+        {
+            if (track_simplifyPush(&s, &fixes[i], &out))
+            {
+                kept.push_back(out);
+            }
+        }
+        if (track_simplifyFlush(&s, &out))
+        {
+            kept.push_back(out);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        uint32_t bytes = bench_pack(kept, decoded);
+        double maxM, meanM;
+        bench_error(fixes, decoded, &maxM, &meanM);
+        printf("%8.1f %8zu %9lu %7.2f %7.1fx %9.2f %9.2f %8.0f\n", tolerances[t] / 100.0, kept.size(),
+               (unsigned long)bytes, (double)bytes / kept.size(), (double)textBytes / bytes, maxM,
+               meanM, ns / fixes.size());
+    }
+    return 0;
+}